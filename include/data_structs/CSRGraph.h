@@ -0,0 +1,180 @@
+/**
+ * @file CSRGraph.h
+ * @brief Read-only compressed sparse row (CSR) copy of a Graph.
+ * @details Vertices are numbered by slot (their position in Graph::getVertexSet) and
+ * the outgoing edges of slot u are stored contiguously in targets/weights, between
+ * offsets[u] and offsets[u+1]. The position of an edge in those arrays is its edge ID.
+ * Weights are integers, like the values in Distances.csv.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef DA_TP_CLASSES_CSRGRAPH
+#define DA_TP_CLASSES_CSRGRAPH
+
+#include <vector>
+#include <cmath>
+#include <unordered_map>
+#include "Graph.h"
+
+template <class T>
+class CSRGraph {
+public:
+    CSRGraph() {}
+    /*
+     * Builds the CSR form of a graph, keeping the slot order of its vertex set.
+     */
+    explicit CSRGraph(const Graph<T> &g);
+
+    int getNumVertex() const;
+    int getNumEdges() const;
+
+    /*
+     * Finds the slot of a vertex with a given content; returns -1 if it does not exist.
+     */
+    int findSlot(const T &in) const;
+    T getInfo(int slot) const;
+    bool hasParking(int slot) const;
+
+    int edgeBegin(int slot) const; // first edge ID of slot
+    int edgeEnd(int slot) const;   // one past the last edge ID of slot
+    int getTarget(int edge) const;
+    int getWeight(int edge) const;
+    void setWeight(int edge, int w);
+
+    const std::vector<int> &getOffsets() const;
+    const std::vector<int> &getTargets() const;
+    const std::vector<int> &getWeights() const;
+
+    /*
+     * Returns the graph with every edge reversed. Edge e of the result is the reverse
+     * of edge getReverseEdgeIds()[e] of this graph.
+     */
+    CSRGraph<T> reversed(std::vector<int> *reverseEdgeIds = nullptr) const;
+
+protected:
+    std::vector<int> offsets;          // size V + 1
+    std::vector<int> targets;          // size E, destination slot of every edge
+    std::vector<int> weights;          // size E
+    std::vector<T> info;               // slot -> vertex content
+    std::vector<char> parking;         // slot -> parking flag
+    std::unordered_map<T, int> slotOf; // vertex content -> slot
+};
+
+template <class T>
+CSRGraph<T>::CSRGraph(const Graph<T> &g) {
+    auto vs = g.getVertexSet();
+    std::unordered_map<Vertex<T> *, int> slot;
+    for (unsigned i = 0; i < vs.size(); i++) {
+        slot[vs[i]] = i;
+        slotOf[vs[i]->getInfo()] = i;
+        info.push_back(vs[i]->getInfo());
+        parking.push_back(vs[i]->hasParking());
+    }
+    offsets.reserve(vs.size() + 1);
+    offsets.push_back(0);
+    for (auto v : vs) {
+        for (auto e : v->getAdj()) {
+            targets.push_back(slot[e->getDest()]);
+            weights.push_back((int) std::lround(e->getWeight()));
+        }
+        offsets.push_back(targets.size());
+    }
+}
+
+template <class T>
+int CSRGraph<T>::getNumVertex() const {
+    return info.size();
+}
+
+template <class T>
+int CSRGraph<T>::getNumEdges() const {
+    return targets.size();
+}
+
+template <class T>
+int CSRGraph<T>::findSlot(const T &in) const {
+    auto it = slotOf.find(in);
+    return it == slotOf.end() ? -1 : it->second;
+}
+
+template <class T>
+T CSRGraph<T>::getInfo(int slot) const {
+    return info[slot];
+}
+
+template <class T>
+bool CSRGraph<T>::hasParking(int slot) const {
+    return parking[slot];
+}
+
+template <class T>
+int CSRGraph<T>::edgeBegin(int slot) const {
+    return offsets[slot];
+}
+
+template <class T>
+int CSRGraph<T>::edgeEnd(int slot) const {
+    return offsets[slot + 1];
+}
+
+template <class T>
+int CSRGraph<T>::getTarget(int edge) const {
+    return targets[edge];
+}
+
+template <class T>
+int CSRGraph<T>::getWeight(int edge) const {
+    return weights[edge];
+}
+
+template <class T>
+void CSRGraph<T>::setWeight(int edge, int w) {
+    weights[edge] = w;
+}
+
+template <class T>
+const std::vector<int> &CSRGraph<T>::getOffsets() const {
+    return offsets;
+}
+
+template <class T>
+const std::vector<int> &CSRGraph<T>::getTargets() const {
+    return targets;
+}
+
+template <class T>
+const std::vector<int> &CSRGraph<T>::getWeights() const {
+    return weights;
+}
+
+template <class T>
+CSRGraph<T> CSRGraph<T>::reversed(std::vector<int> *reverseEdgeIds) const {
+    CSRGraph<T> r;
+    r.info = info;
+    r.parking = parking;
+    r.slotOf = slotOf;
+    int n = getNumVertex(), m = getNumEdges();
+    r.offsets.assign(n + 1, 0);
+    for (int e = 0; e < m; e++)
+        r.offsets[targets[e] + 1]++;
+    for (int u = 0; u < n; u++)
+        r.offsets[u + 1] += r.offsets[u];
+    r.targets.resize(m);
+    r.weights.resize(m);
+    if (reverseEdgeIds != nullptr)
+        reverseEdgeIds->resize(m);
+    std::vector<int> pos(r.offsets.begin(), r.offsets.end() - 1);
+    for (int u = 0; u < n; u++) {
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            int k = pos[targets[e]]++;
+            r.targets[k] = u;
+            r.weights[k] = weights[e];
+            if (reverseEdgeIds != nullptr)
+                (*reverseEdgeIds)[k] = e;
+        }
+    }
+    return r;
+}
+
+#endif /* DA_TP_CLASSES_CSRGRAPH */
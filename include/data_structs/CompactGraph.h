@@ -0,0 +1,256 @@
+/**
+ * @file CompactGraph.h
+ * @brief Memory-compact, read-only copy of a Graph with varint-encoded adjacency.
+ * @details Vertices are numbered by slot, as in CSRGraph. The outgoing edges of each
+ * slot are sorted by target and stored in a single byte stream, between offsets[u] and
+ * offsets[u+1]:
+ *
+ *     edge := target delta (varint) | weight (uint16, little-endian) [| weight (varint)]
+ *
+ * The first target is stored relative to the slot itself (zigzag, since it may be
+ * smaller), the next ones relative to the previous target. Weights below 0xFFFF take
+ * two bytes; 0xFFFF escapes to a varint holding the full weight. A typical edge takes
+ * 3-4 bytes, against an Edge object plus two pointers in the adjacency lists.
+ * Weights must be non-negative integers, like the values in Distances.csv.
+ *
+ * Besides a Graph, a CompactGraph can be built from a CSRGraph or from a GraphLayer of
+ * a MultiLayerGraph. Loading the csv files with loadNetwork and encoding a layer never
+ * creates the pointer-based Graph, so the peak heap stays close to the final size.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef DA_TP_CLASSES_COMPACTGRAPH
+#define DA_TP_CLASSES_COMPACTGRAPH
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include "Graph.h"
+#include "CSRGraph.h"
+#include "MultiLayerGraph.h"
+
+#define COMPACT_WEIGHT_ESCAPE 0xFFFF
+
+template <class T>
+class CompactGraph {
+public:
+    CompactGraph() {}
+    /*
+     * Builds the compact form of a graph, keeping the slot order of its vertex set.
+     */
+    explicit CompactGraph(const Graph<T> &g);
+    /*
+     * Builds the compact form of a CSR graph or of one layer, keeping its slot order.
+     */
+    explicit CompactGraph(const CSRGraph<T> &g);
+    explicit CompactGraph(const GraphLayer<T> &layer);
+
+    int getNumVertex() const;
+    int getNumEdges() const;
+
+    /*
+     * Finds the slot of a vertex with a given content; returns -1 if it does not exist.
+     */
+    int findSlot(const T &in) const;
+    T getInfo(int slot) const;
+    bool hasParking(int slot) const;
+
+    /*
+     * Calls f(target, weight) for every outgoing edge of a slot, by increasing target.
+     */
+    template <class F>
+    void forEachEdge(int slot, F f) const;
+
+    /*
+     * Bytes used by this graph, including the slot lookup table.
+     */
+    size_t memoryBytes() const;
+
+protected:
+    std::vector<uint32_t> offsets;          // size V + 1, byte offsets into stream
+    std::vector<uint8_t> stream;            // encoded edges
+    std::vector<T> info;                    // slot -> vertex content
+    std::vector<bool> parking;              // slot -> parking flag
+    std::vector<std::pair<T, int>> slotOf;  // (vertex content, slot), sorted by content
+    int numEdges = 0;
+
+    void putVarint(uint32_t x);
+    static uint32_t getVarint(const uint8_t *&p);
+    void addSlot(const T &in, bool park);
+    void encodeEdges(int u, std::vector<std::pair<int, uint32_t>> &out);
+    template <class G>
+    void buildFromCSR(const G &g);
+};
+
+template <class T>
+void CompactGraph<T>::putVarint(uint32_t x) {
+    while (x >= 0x80) {
+        stream.push_back((uint8_t) (x | 0x80));
+        x >>= 7;
+    }
+    stream.push_back((uint8_t) x);
+}
+
+template <class T>
+inline uint32_t CompactGraph<T>::getVarint(const uint8_t *&p) {
+    uint32_t x = *p++;
+    if (x < 0x80) return x; // the common case: one byte
+    x &= 0x7F;
+    for (int shift = 7;; shift += 7) {
+        uint32_t b = *p++;
+        x |= (b & 0x7F) << shift;
+        if (b < 0x80) return x;
+    }
+}
+
+template <class T>
+void CompactGraph<T>::addSlot(const T &in, bool park) {
+    slotOf.push_back({in, (int) info.size()});
+    info.push_back(in);
+    parking.push_back(park);
+}
+
+/*
+ * Appends the edges (target slot, weight) of slot u to the stream, sorted by target.
+ */
+template <class T>
+void CompactGraph<T>::encodeEdges(int u, std::vector<std::pair<int, uint32_t>> &out) {
+    std::sort(out.begin(), out.end());
+    int prev = u;
+    for (unsigned i = 0; i < out.size(); i++) {
+        int d = out[i].first - prev;
+        putVarint(i == 0 ? ((uint32_t) d << 1) ^ (uint32_t) (d >> 31) : (uint32_t) d);
+        prev = out[i].first;
+        uint32_t w = out[i].second;
+        uint32_t w16 = std::min<uint32_t>(w, COMPACT_WEIGHT_ESCAPE);
+        stream.push_back((uint8_t) (w16 & 0xFF));
+        stream.push_back((uint8_t) (w16 >> 8));
+        if (w16 == COMPACT_WEIGHT_ESCAPE) putVarint(w);
+    }
+    numEdges += out.size();
+    offsets.push_back(stream.size());
+}
+
+template <class T>
+CompactGraph<T>::CompactGraph(const Graph<T> &g) {
+    auto vs = g.getVertexSet();
+    std::unordered_map<Vertex<T> *, int> slot;
+    for (unsigned i = 0; i < vs.size(); i++) {
+        slot[vs[i]] = i;
+        addSlot(vs[i]->getInfo(), vs[i]->hasParking());
+    }
+    std::sort(slotOf.begin(), slotOf.end());
+
+    offsets.reserve(vs.size() + 1);
+    offsets.push_back(0);
+    std::vector<std::pair<int, uint32_t>> out;
+    for (unsigned u = 0; u < vs.size(); u++) {
+        out.clear();
+        for (auto e : vs[u]->getAdj())
+            out.push_back({slot[e->getDest()], (uint32_t) std::lround(e->getWeight())});
+        encodeEdges(u, out);
+    }
+    stream.shrink_to_fit();
+}
+
+template <class T>
+template <class G>
+void CompactGraph<T>::buildFromCSR(const G &g) {
+    for (int u = 0; u < g.getNumVertex(); u++) addSlot(g.getInfo(u), g.hasParking(u));
+    std::sort(slotOf.begin(), slotOf.end());
+
+    offsets.reserve(g.getNumVertex() + 1);
+    offsets.push_back(0);
+    stream.reserve(g.getNumEdges() * 4);
+    std::vector<std::pair<int, uint32_t>> out;
+    for (int u = 0; u < g.getNumVertex(); u++) {
+        out.clear();
+        for (int e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+            out.push_back({g.getTarget(e), (uint32_t) g.getWeight(e)});
+        encodeEdges(u, out);
+    }
+    stream.shrink_to_fit();
+}
+
+template <class T>
+CompactGraph<T>::CompactGraph(const CSRGraph<T> &g) {
+    buildFromCSR(g);
+}
+
+template <class T>
+CompactGraph<T>::CompactGraph(const GraphLayer<T> &layer) {
+    buildFromCSR(layer);
+}
+
+template <class T>
+int CompactGraph<T>::getNumVertex() const {
+    return info.size();
+}
+
+template <class T>
+int CompactGraph<T>::getNumEdges() const {
+    return numEdges;
+}
+
+template <class T>
+int CompactGraph<T>::findSlot(const T &in) const {
+    auto it = std::lower_bound(slotOf.begin(), slotOf.end(), std::make_pair(in, -1));
+    return it != slotOf.end() && it->first == in ? it->second : -1;
+}
+
+template <class T>
+T CompactGraph<T>::getInfo(int slot) const {
+    return info[slot];
+}
+
+template <class T>
+bool CompactGraph<T>::hasParking(int slot) const {
+    return parking[slot];
+}
+
+template <class T>
+template <class F>
+inline void CompactGraph<T>::forEachEdge(int slot, F f) const {
+    const uint8_t *p = stream.data() + offsets[slot], *end = stream.data() + offsets[slot + 1];
+    if (p == end) return;
+    uint32_t z = getVarint(p);
+    int target = slot + (int) ((z >> 1) ^ -(z & 1));
+    while (true) {
+        int w = p[0] | (p[1] << 8);
+        p += 2;
+        if (w == COMPACT_WEIGHT_ESCAPE) w = getVarint(p);
+        f(target, w);
+        if (p == end) return;
+        target += getVarint(p);
+    }
+}
+
+template <class T>
+size_t CompactGraph<T>::memoryBytes() const {
+    return sizeof(*this) + offsets.capacity() * sizeof(uint32_t) + stream.capacity() +
+           info.capacity() * sizeof(T) + parking.capacity() / 8 + slotOf.capacity() * sizeof(std::pair<T, int>);
+}
+
+/**
+ * @brief Estimates the bytes used by a pointer-based Graph.
+ * @details Counts the vertex and edge objects (excluding allocator overhead), the
+ * outgoing and incoming edge lists and the vertex set.
+ * @complexity O(V).
+ */
+template <class T>
+size_t graphMemoryBytes(const Graph<T> &g) {
+    auto vs = g.getVertexSet();
+    size_t bytes = sizeof(g) + vs.capacity() * sizeof(Vertex<T> *);
+    for (auto v : vs) {
+        bytes += sizeof(Vertex<T>);
+        bytes += v->getAdj().size() * (sizeof(Edge<T>) + sizeof(Edge<T> *));
+        bytes += v->getIncoming().size() * sizeof(Edge<T> *);
+    }
+    return bytes;
+}
+
+#endif //DA_TP_CLASSES_COMPACTGRAPH
@@ -13,6 +13,7 @@
 #include <limits>
 #include <algorithm>
 #include "../data_structs/MutablePriorityQueue.h" // not needed for now
+#include "../helper/memoryStats.h"
 
 template <class T>
 class Edge;
@@ -28,7 +29,7 @@ public:
     bool operator<(Vertex<T> & vertex) const; // // required by MutablePriorityQueue
 
     T getInfo() const;
-    std::vector<Edge<T> *> getAdj() const;
+    const std::vector<Edge<T> *> &getAdj() const;
     bool hasParking() const; ///< checks if the node has parking
     bool isVisited() const;
     bool isProcessing() const;
@@ -46,6 +47,10 @@ public:
     void setLow(int value);
     int getNum() const;
     void setNum(int value);
+    int getComponent() const;
+    void setComponent(int component);
+    int getWeakComponent() const;
+    void setWeakComponent(int component);
 
     void setIndegree(unsigned int indegree);
     void setDist(double dist);
@@ -64,6 +69,7 @@ protected:
     bool visited = false; // used by DFS, BFS, Prim ...
     bool processing = false; // used by isDAG (in addition to the visited attribute)
     int low = -1, num = -1; // used by SCC Tarjan
+    int component = -1, weakComponent = -1; // reachability labels (see scc.h)
     unsigned int indegree; // used by topsort
     double dist = 0;
     Edge<T> *path = nullptr;
@@ -111,6 +117,9 @@ protected:
 template <class T>
 class Graph {
 public:
+    Graph() {}
+    Graph(const Graph &) = delete; // owns its vertices and edges
+    Graph &operator=(const Graph &) = delete;
     ~Graph();
     /*
     * Auxiliary function to find a vertex with a given the content.
@@ -136,13 +145,17 @@ public:
 
     std::vector<Vertex<T> *> getVertexSet() const;
 
+    /*
+     * Renumbers the internal vertex slots: order[k] is the current slot of the vertex
+     * that is placed at slot k. Vertices and edges are reallocated in the new order.
+     * Returns false if order is not a permutation of the current slots.
+     */
+    bool reorderVertices(const std::vector<int> &order);
+
 
 protected:
     std::vector<Vertex<T> *> vertexSet;    // vertex set
 
-    double ** distMatrix = nullptr;   // dist matrix for Floyd-Warshall
-    int **pathMatrix = nullptr;   // path matrix for Floyd-Warshall
-
     /*
      * Finds the index of the vertex with a given content.
      */
@@ -153,9 +166,6 @@ protected:
 
 };
 
-void deleteMatrix(int **m, int n);
-void deleteMatrix(double **m, int n);
-
 
 /************************* Vertex  **************************/
 
@@ -167,6 +177,7 @@ Vertex<T>::Vertex(T in): info(in) {}
  */
 template <class T>
 Edge<T> * Vertex<T>::addEdge(Vertex<T> *d, double w) {
+    MemoryScope scope(MEM_GRAPH);
     auto newEdge = new Edge<T>(this, d, w);
     adj.push_back(newEdge);
     d->incoming.push_back(newEdge);
@@ -259,7 +270,27 @@ void Vertex<T>::setNum(int value) {
 }
 
 template <class T>
-std::vector<Edge<T>*> Vertex<T>::getAdj() const {
+int Vertex<T>::getComponent() const {
+    return this->component;
+}
+
+template <class T>
+void Vertex<T>::setComponent(int component) {
+    this->component = component;
+}
+
+template <class T>
+int Vertex<T>::getWeakComponent() const {
+    return this->weakComponent;
+}
+
+template <class T>
+void Vertex<T>::setWeakComponent(int component) {
+    this->weakComponent = component;
+}
+
+template <class T>
+const std::vector<Edge<T>*> &Vertex<T>::getAdj() const {
     return this->adj;
 }
 
@@ -428,6 +459,7 @@ int Graph<T>::findVertexIdx(const T &in) const {
  */
 template <class T>
 bool Graph<T>::addVertex(const T &in) {
+    MemoryScope scope(MEM_GRAPH);
     if (findVertex(in) != nullptr)
         return false;
     vertexSet.push_back(new Vertex<T>(in));
@@ -445,7 +477,14 @@ bool Graph<T>::removeVertex(const T &in) {
         if ((*it)->getInfo() == in) {
             auto v = *it;
             v->removeOutgoingEdges();
-            for (auto u : vertexSet) {
+            // only the origins of incoming edges can point to v
+            std::vector<Vertex<T> *> origins;
+            for (auto e : v->getIncoming()) {
+                origins.push_back(e->getOrig());
+            }
+            std::sort(origins.begin(), origins.end());
+            origins.erase(std::unique(origins.begin(), origins.end()), origins.end());
+            for (auto u : origins) {
                 u->removeEdge(v->getInfo());
             }
             vertexSet.erase(it);
@@ -498,28 +537,76 @@ bool Graph<T>::addBidirectionalEdge(const T &sourc, const T &dest, double w) {
     return true;
 }
 
-inline void deleteMatrix(int **m, int n) {
-    if (m != nullptr) {
-        for (int i = 0; i < n; i++)
-            if (m[i] != nullptr)
-                delete [] m[i];
-        delete [] m;
+/*
+ * Renumbers the internal vertex slots: order[k] is the current slot of the vertex
+ * that is placed at slot k. Vertex contents, parking flags, component labels, edge weights and reverse
+ * edges are kept. Vertices are reallocated first, in slot order, followed by the
+ * outgoing edges of each vertex, so that consecutive slots end up close in memory.
+ * Returns false if order is not a permutation of the current slots.
+ */
+template <class T>
+bool Graph<T>::reorderVertices(const std::vector<int> &order) {
+    int n = vertexSet.size();
+    if ((int) order.size() != n)
+        return false;
+    std::vector<int> newSlot(n, -1);
+    for (int k = 0; k < n; k++) {
+        if (order[k] < 0 || order[k] >= n || newSlot[order[k]] != -1)
+            return false;
+        newSlot[order[k]] = k;
+    }
+
+    std::vector<Vertex<T> *> newSet(n);
+    for (int k = 0; k < n; k++) {
+        newSet[k] = new Vertex<T>(vertexSet[order[k]]->getInfo());
+        newSet[k]->setParking(vertexSet[order[k]]->hasParking());
+        newSet[k]->setComponent(vertexSet[order[k]]->getComponent());
+        newSet[k]->setWeakComponent(vertexSet[order[k]]->getWeakComponent());
     }
-}
 
-inline void deleteMatrix(double **m, int n) {
-    if (m != nullptr) {
-        for (int i = 0; i < n; i++)
-            if (m[i] != nullptr)
-                delete [] m[i];
-        delete [] m;
+    std::vector<Vertex<T> *> oldSet = vertexSet;
+    std::vector<std::pair<Vertex<T> *, int>> oldSlot(n); // old vertex -> old slot, sorted for lookup
+    for (int i = 0; i < n; i++)
+        oldSlot[i] = {oldSet[i], i};
+    std::sort(oldSlot.begin(), oldSlot.end());
+
+    std::vector<std::pair<Edge<T> *, Edge<T> *>> edgeMap; // (old, new), to rebuild reverse links
+    for (int k = 0; k < n; k++) {
+        for (auto e : oldSet[order[k]]->getAdj()) {
+            int d = std::lower_bound(oldSlot.begin(), oldSlot.end(),
+                                     std::make_pair(e->getDest(), -1))->second;
+            edgeMap.push_back({e, newSet[k]->addEdge(newSet[newSlot[d]], e->getWeight())});
+        }
     }
+    std::sort(edgeMap.begin(), edgeMap.end());
+    for (auto &p : edgeMap) {
+        if (p.first->getReverse() == nullptr)
+            continue;
+        auto it = std::lower_bound(edgeMap.begin(), edgeMap.end(),
+                                   std::make_pair(p.first->getReverse(), (Edge<T> *) nullptr));
+        if (it != edgeMap.end() && it->first == p.first->getReverse())
+            p.second->setReverse(it->second);
+    }
+
+    for (auto v : oldSet) {
+        for (auto e : v->getAdj())
+            delete e;
+        delete v;
+    }
+    vertexSet = newSet;
+    return true;
 }
 
+/*
+ * Deletes every edge, then every vertex.
+ */
 template <class T>
 Graph<T>::~Graph() {
-    deleteMatrix(distMatrix, vertexSet.size());
-    deleteMatrix(pathMatrix, vertexSet.size());
+    for (auto v : vertexSet)
+        for (auto e : v->getAdj())
+            delete e;
+    for (auto v : vertexSet)
+        delete v;
 }
 
 #endif /* DA_TP_CLASSES_GRAPH */
\ No newline at end of file
@@ -0,0 +1,304 @@
+/**
+ * @file MultiLayerGraph.h
+ * @brief Graph with one shared vertex table and one CSR adjacency per travel mode.
+ * @details loadLocations stores every location twice, as a Vertex of the driving graph
+ * and another of the walking graph. A MultiLayerGraph keeps the locations (content,
+ * parking flag, content -> slot map) once, and each mode is a GraphLayer holding only
+ * offsets/targets/weights over those slots. Slot s is the same location in every
+ * layer, so a search can move between layers at a slot without any lookup.
+ *
+ * A GraphLayer has the read interface of CSRGraph, so csrDijkstra and csrGetPath
+ * search each layer on its own. Edges are staged by addEdge and laid out by build();
+ * searches see the edges added up to the last build. Edges keep the order they were
+ * added in, so a layer built from the csv files has the same edge IDs as the CSRGraph
+ * of the corresponding Graph.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef DA_TP_CLASSES_MULTILAYERGRAPH
+#define DA_TP_CLASSES_MULTILAYERGRAPH
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "../helper/memoryStats.h"
+
+template <class T>
+class MultiLayerGraph;
+
+/*
+ * Adjacency of one mode over the vertex table of a MultiLayerGraph, in CSR form.
+ */
+template <class T>
+class GraphLayer {
+public:
+    const std::string &getName() const;
+    int getNumVertex() const;
+    int getNumEdges() const;
+
+    /*
+     * Vertex table lookups, answered by the MultiLayerGraph that owns the layer.
+     */
+    int findSlot(const T &in) const;
+    T getInfo(int slot) const;
+    bool hasParking(int slot) const;
+
+    int edgeBegin(int slot) const; // first edge ID of slot
+    int edgeEnd(int slot) const;   // one past the last edge ID of slot
+    int getTarget(int edge) const;
+    int getWeight(int edge) const;
+    void setWeight(int edge, int w);
+
+    const std::vector<int> &getOffsets() const;
+    const std::vector<int> &getTargets() const;
+    const std::vector<int> &getWeights() const;
+
+private:
+    friend class MultiLayerGraph<T>;
+
+    struct PendingEdge {
+        int from, to, weight;
+    };
+
+    const MultiLayerGraph<T> *owner = nullptr;
+    std::string name;
+    std::vector<int> offsets{0};       // size V + 1 after build
+    std::vector<int> targets;          // size E, destination slot of every edge
+    std::vector<int> weights;          // size E
+    std::vector<PendingEdge> pending;  // added since the last build
+};
+
+template <class T>
+class MultiLayerGraph {
+public:
+    MultiLayerGraph() {}
+    MultiLayerGraph(const MultiLayerGraph &) = delete;            // layers point back to
+    MultiLayerGraph &operator=(const MultiLayerGraph &) = delete; // their graph
+
+    /*
+     * Adds a location to the shared table and returns its slot (the existing slot if
+     * it is already there).
+     */
+    int addVertex(const T &in, bool parking = false);
+    /*
+     * Adds a mode and returns its layer index (the existing index if the name is taken).
+     */
+    int addLayer(const std::string &name);
+    /*
+     * Stages an edge of a layer; returns false if a vertex or the layer does not exist.
+     */
+    bool addEdge(int layer, const T &sourc, const T &dest, int w);
+    /*
+     * Lays out the staged edges of every layer. Required after adding vertices or edges.
+     */
+    void build();
+
+    int getNumVertex() const;
+    int getNumLayers() const;
+    int findLayer(const std::string &name) const; // -1 if there is no such layer
+    const GraphLayer<T> &getLayer(int layer) const;
+    GraphLayer<T> &getLayer(int layer);
+
+    int findSlot(const T &in) const; // -1 if it does not exist
+    T getInfo(int slot) const;
+    bool hasParking(int slot) const;
+    void setParking(int slot, bool parking);
+
+protected:
+    std::vector<T> info;               // slot -> vertex content
+    std::vector<char> parking;         // slot -> parking flag
+    std::unordered_map<T, int> slotOf; // vertex content -> slot
+    std::vector<GraphLayer<T>> layers;
+};
+
+/************************* GraphLayer  **************************/
+
+template <class T>
+const std::string &GraphLayer<T>::getName() const {
+    return name;
+}
+
+template <class T>
+int GraphLayer<T>::getNumVertex() const {
+    return offsets.size() - 1;
+}
+
+template <class T>
+int GraphLayer<T>::getNumEdges() const {
+    return targets.size();
+}
+
+template <class T>
+int GraphLayer<T>::findSlot(const T &in) const {
+    return owner->findSlot(in);
+}
+
+template <class T>
+T GraphLayer<T>::getInfo(int slot) const {
+    return owner->getInfo(slot);
+}
+
+template <class T>
+bool GraphLayer<T>::hasParking(int slot) const {
+    return owner->hasParking(slot);
+}
+
+template <class T>
+int GraphLayer<T>::edgeBegin(int slot) const {
+    return offsets[slot];
+}
+
+template <class T>
+int GraphLayer<T>::edgeEnd(int slot) const {
+    return offsets[slot + 1];
+}
+
+template <class T>
+int GraphLayer<T>::getTarget(int edge) const {
+    return targets[edge];
+}
+
+template <class T>
+int GraphLayer<T>::getWeight(int edge) const {
+    return weights[edge];
+}
+
+template <class T>
+void GraphLayer<T>::setWeight(int edge, int w) {
+    weights[edge] = w;
+}
+
+template <class T>
+const std::vector<int> &GraphLayer<T>::getOffsets() const {
+    return offsets;
+}
+
+template <class T>
+const std::vector<int> &GraphLayer<T>::getTargets() const {
+    return targets;
+}
+
+template <class T>
+const std::vector<int> &GraphLayer<T>::getWeights() const {
+    return weights;
+}
+
+/************************* MultiLayerGraph  **************************/
+
+template <class T>
+int MultiLayerGraph<T>::addVertex(const T &in, bool p) {
+    MemoryScope scope(MEM_GRAPH);
+    auto it = slotOf.find(in);
+    if (it != slotOf.end()) return it->second;
+    int slot = info.size();
+    slotOf[in] = slot;
+    info.push_back(in);
+    parking.push_back(p);
+    return slot;
+}
+
+template <class T>
+int MultiLayerGraph<T>::addLayer(const std::string &name) {
+    MemoryScope scope(MEM_GRAPH);
+    int existing = findLayer(name);
+    if (existing != -1) return existing;
+    layers.emplace_back();
+    layers.back().name = name;
+    for (auto &l : layers) l.owner = this; // the vector may have moved them
+    return layers.size() - 1;
+}
+
+template <class T>
+bool MultiLayerGraph<T>::addEdge(int layer, const T &sourc, const T &dest, int w) {
+    MemoryScope scope(MEM_GRAPH);
+    int u = findSlot(sourc), v = findSlot(dest);
+    if (u == -1 || v == -1 || layer < 0 || layer >= getNumLayers()) return false;
+    layers[layer].pending.push_back({u, v, w});
+    return true;
+}
+
+/*
+ * Counting sort of the built and staged edges by origin slot, stable, so each slot
+ * keeps its previous edges first and then the staged ones in the order they came.
+ * O(V + E) per layer.
+ */
+template <class T>
+void MultiLayerGraph<T>::build() {
+    MemoryScope scope(MEM_GRAPH);
+    int n = getNumVertex();
+    for (auto &l : layers) {
+        int built = l.offsets.size() - 1;
+        std::vector<int> offsets(n + 1, 0);
+        for (int u = 0; u < built; u++) offsets[u + 1] = l.offsets[u + 1] - l.offsets[u];
+        for (auto &e : l.pending) offsets[e.from + 1]++;
+        for (int u = 0; u < n; u++) offsets[u + 1] += offsets[u];
+
+        std::vector<int> targets(offsets[n]), weights(offsets[n]);
+        std::vector<int> pos(offsets.begin(), offsets.end() - 1);
+        for (int u = 0; u < built; u++) {
+            for (int e = l.offsets[u]; e < l.offsets[u + 1]; e++) {
+                targets[pos[u]] = l.targets[e];
+                weights[pos[u]++] = l.weights[e];
+            }
+        }
+        for (auto &e : l.pending) {
+            targets[pos[e.from]] = e.to;
+            weights[pos[e.from]++] = e.weight;
+        }
+        l.offsets.swap(offsets);
+        l.targets.swap(targets);
+        l.weights.swap(weights);
+        std::vector<typename GraphLayer<T>::PendingEdge>().swap(l.pending);
+    }
+}
+
+template <class T>
+int MultiLayerGraph<T>::getNumVertex() const {
+    return info.size();
+}
+
+template <class T>
+int MultiLayerGraph<T>::getNumLayers() const {
+    return layers.size();
+}
+
+template <class T>
+int MultiLayerGraph<T>::findLayer(const std::string &name) const {
+    for (unsigned i = 0; i < layers.size(); i++)
+        if (layers[i].name == name) return i;
+    return -1;
+}
+
+template <class T>
+const GraphLayer<T> &MultiLayerGraph<T>::getLayer(int layer) const {
+    return layers[layer];
+}
+
+template <class T>
+GraphLayer<T> &MultiLayerGraph<T>::getLayer(int layer) {
+    return layers[layer];
+}
+
+template <class T>
+int MultiLayerGraph<T>::findSlot(const T &in) const {
+    auto it = slotOf.find(in);
+    return it == slotOf.end() ? -1 : it->second;
+}
+
+template <class T>
+T MultiLayerGraph<T>::getInfo(int slot) const {
+    return info[slot];
+}
+
+template <class T>
+bool MultiLayerGraph<T>::hasParking(int slot) const {
+    return parking[slot];
+}
+
+template <class T>
+void MultiLayerGraph<T>::setParking(int slot, bool p) {
+    parking[slot] = p;
+}
+
+#endif /* DA_TP_CLASSES_MULTILAYERGRAPH */
@@ -9,6 +9,7 @@
 #define DA_TP_CLASSES_MUTABLEPRIORITYQUEUE
 
 #include <vector>
+#include "../helper/memoryStats.h"
 
 /**
  * class T must have: (i) accessible field int queueIndex; (ii) operator< defined.
@@ -34,6 +35,7 @@ public:
 
 template <class T>
 MutablePriorityQueue<T>::MutablePriorityQueue() {
+    MemoryScope scope(MEM_QUEUE);
     H.push_back(nullptr);
     // indices will be used starting in 1
     // to facilitate parent/child calculations
@@ -56,6 +58,7 @@ T* MutablePriorityQueue<T>::extractMin() {
 
 template <class T>
 void MutablePriorityQueue<T>::insert(T *x) {
+    MemoryScope scope(MEM_QUEUE);
     H.push_back(x);
     heapifyUp(H.size()-1);
 }
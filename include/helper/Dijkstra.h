@@ -12,20 +12,26 @@
 #include <vector>
 #include "../data_structs/MutablePriorityQueue.h"
 #include "../data_structs/Graph.h"
+#include "searchControl.h"
 #include <algorithm>
 using namespace std;
 
 /**
  * @brief Runs Dijkstra's shortest path algorithm.
  * @details Initializes distances, inserts the source node into a priority queue, and relaxes edges iteratively.
+ * If a SearchControl is given, the search stops when it does; the vertices settled so
+ * far keep their exact distances and the others their tentative ones.
  *
  * @tparam T Type of the graph vertices.
  * @param g Pointer to the graph.
  * @param origin Source vertex for shortest path computation.
+ * @param control Deadline and cancellation of the search (nullptr for none).
+ * @return False if the search was stopped by control before it finished.
  * @complexity O((V + E) log V), where V is the number of vertices and E is the number of edges.
  */
 template <class T>
-void dijkstra(Graph<T> * g, const int &origin) {
+bool dijkstra(Graph<T> * g, const int &origin, SearchControl *control = nullptr) {
+    MemoryScope scope(MEM_SEARCH);
     auto vertSet = g->getVertexSet();
     for (auto v : vertSet) {
         v->setDist(INF);
@@ -33,16 +39,19 @@ void dijkstra(Graph<T> * g, const int &origin) {
         v->setVisited(false);
     }
     Vertex<T> *start = g->findVertex(origin);
-    if (start == nullptr) return;
+    if (start == nullptr) return true;
     start->setDist(0);
     MutablePriorityQueue<Vertex<T>> q;
     q.insert(start);
     while (!q.empty()) {
+        if (control != nullptr && control->tick()) return false;
         auto u = q.extractMin();
         u->setVisited(true);
         for (auto e : u->getAdj()) {
+            if (e->getDest()->isVisited()) continue; // already settled
+            double oldDist = e->getDest()->getDist();
             if (relax(e)) {
-                if (!e->getDest()->isVisited()) {
+                if (oldDist == INF) {
                     q.insert(e->getDest());
                 } else {
                     q.decreaseKey(e->getDest());
@@ -50,6 +59,7 @@ void dijkstra(Graph<T> * g, const int &origin) {
             }
         }
     }
+    return true;
 }
 
 /**
@@ -84,6 +94,7 @@ bool relax(Edge<T> *edge) {
  */
 template <class T>
 std::vector<T> getPath(Graph<T> * g, const int &dest, int & w) {
+    MemoryScope scope(MEM_SEARCH);
     std::vector<T> res;
     Vertex<T> *v = g->findVertex(dest);
     if (v == nullptr || v->getDist() == INF) {
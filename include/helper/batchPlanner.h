@@ -0,0 +1,87 @@
+/**
+ * @file batchPlanner.h
+ * @brief Answers a batch of queries, sharing one shortest-path tree per source.
+ * @details Answering queries one by one rebuilds the graphs and runs a full dijkstra
+ * for each of them, even when many share a source or an include node. answerBatch
+ * plans the whole batch first:
+ *
+ * - an unrestricted query needs the tree of its source;
+ * - a query with only an include node I needs the trees of its source and of I;
+ * - queries with avoided nodes or segments, or with a time limit, keep their own
+ *   graphs and searches, as in answerQuery.
+ *
+ * One graph is built for the batch and one dijkstra runs per distinct tree source;
+ * every route that starts there is read from the tree with getPath. The alternative
+ * route of an unrestricted query still needs its own search, since it depends on the
+ * best route: it runs on the same graph with the interior of the best route blocked
+ * instead of removed, which gives the same route as removePath without rebuilding.
+ * The results are identical to answering each query with answerQuery.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef BATCHPLANNER_H
+#define BATCHPLANNER_H
+
+#include <vector>
+#include "../data_structs/Graph.h"
+#include "queryParser.h"
+#include "hotReload.h"
+#include "searchControl.h"
+using namespace std;
+
+/**
+ * @brief Routes computed for one query.
+ * @details Unrestricted queries fill the best (prim) and alternative (sec) routes;
+ * restricted ones only fill prim.
+ */
+struct QueryAnswer {
+    vector<int> primPath, secPath;
+    int primW = 0, secW = 0;
+    SearchStatus status = SEARCH_OK;
+};
+
+/**
+ * @brief Work done by answerBatch.
+ */
+struct BatchStats {
+    int queries = 0;      ///< queries in the batch
+    int shared = 0;       ///< queries answered from shared trees
+    int trees = 0;        ///< shared trees computed (one per distinct source or include node)
+    int ownSearches = 0;  ///< queries answered with their own graphs and searches
+};
+
+/**
+ * @brief Runs Dijkstra's algorithm as if some vertices had been removed.
+ * @details The blocked vertices are marked as settled before the search, so no edge
+ * into them is relaxed. The search makes the same steps as dijkstra on the graph
+ * without them.
+ *
+ * @param g Pointer to the graph.
+ * @param origin Source vertex ID (must not be blocked).
+ * @param blocked Vertex IDs to leave out.
+ * @complexity O((V + E) log V + B V), for B blocked vertices.
+ */
+void dijkstraWithout(Graph<int> *g, int origin, const vector<int> &blocked);
+
+/**
+ * @brief Answers a single query on its own graphs.
+ * @details Builds the graphs from the snapshot and runs Routing (unrestricted) or
+ * avoidRouting (restricted), honouring the query's time limit.
+ * @complexity O((V + E) log V), plus building the graphs.
+ */
+QueryAnswer answerQuery(const RouteQuery &q, const NetworkSnapshot &net);
+
+/**
+ * @brief Answers a batch of queries, sharing the trees of common sources.
+ * @param queries Queries of the batch.
+ * @param net Network snapshot to route on, for the whole batch.
+ * @param stats Receives the work done (may be nullptr).
+ * @return One answer per query, in the same order.
+ * @complexity O(S (V + E) log V) for S distinct tree sources, plus one search per
+ * alternative route and the own searches of restricted queries.
+ */
+vector<QueryAnswer> answerBatch(const vector<RouteQuery> &queries, const NetworkSnapshot &net,
+                                BatchStats *stats = nullptr);
+
+#endif //BATCHPLANNER_H
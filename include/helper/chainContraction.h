@@ -0,0 +1,173 @@
+/**
+ * @file chainContraction.h
+ * @brief Collapses degree-2 chains of a graph into single weighted edges.
+ * @details Most locations of a road network only join two segments. Each one costs a
+ * vertex allocation and a heap operation in dijkstra, yet a shortest route entering
+ * such a vertex has only one way out. contractChains removes them and links their
+ * neighbours with a shortcut edge whose weight is the sum of the two segments:
+ *
+ * - one-way: v has a single incoming edge u->v and a single outgoing edge v->w;
+ *   the shortcut is u->w.
+ * - two-way: v has exactly the edges a->v, v->a, b->v and v->b; the shortcuts are
+ *   a->b and b->a.
+ *
+ * Repeating this until no vertex qualifies collapses maximal chains. Edges cut with
+ * 'X' are simply absent from the graph, so direction and cuts are respected by
+ * construction. A vertex is not contracted if a shortcut would run parallel to an
+ * existing edge, so every edge stays either an original segment or a single chain.
+ *
+ * Vertices that queries reference (source, destination, include and avoid nodes, ends
+ * of avoided segments) must be passed as kept, and parking vertices are kept by
+ * default, since the driving-walking mode switches there. The ChainMap records the
+ * vertices hidden by each shortcut; expand turns a route of the contracted graph back
+ * into the full vertex sequence getPath returns on the original one, with the same
+ * weight.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef CHAINCONTRACTION_H
+#define CHAINCONTRACTION_H
+
+#include <vector>
+#include <map>
+#include <utility>
+#include <unordered_set>
+#include <algorithm>
+#include "../data_structs/Graph.h"
+using namespace std;
+
+/**
+ * @brief The vertices hidden by each shortcut edge of a contracted graph.
+ */
+class ChainMap {
+public:
+    /**
+     * @brief Vertex IDs hidden by the shortcut u->w, in route order.
+     * @return The interior of the chain, or nullptr if u->w is an original segment.
+     */
+    const vector<int> *interior(int u, int w) const {
+        auto it = chains.find(make_pair(u, w));
+        return it == chains.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * @brief Records that the shortcut u->w replaces the route u->v->w.
+     * @details The shortcuts u->v and v->w, if any, are merged into it.
+     */
+    void join(int u, int v, int w) {
+        vector<int> chain;
+        take(u, v, chain);
+        chain.push_back(v);
+        take(v, w, chain);
+        chains[make_pair(u, w)] = chain;
+    }
+
+    /**
+     * @brief Expands a route of the contracted graph into the route of the original graph.
+     * @param path Vertex IDs of the route, as returned by getPath.
+     * @return The same route with the interior of every shortcut inserted.
+     * @complexity O(k log C + n), for k route vertices, C chains and n output vertices.
+     */
+    vector<int> expand(const vector<int> &path) const {
+        vector<int> full;
+        for (size_t i = 0; i < path.size(); i++) {
+            if (i > 0) {
+                const vector<int> *chain = interior(path[i - 1], path[i]);
+                if (chain != nullptr) full.insert(full.end(), chain->begin(), chain->end());
+            }
+            full.push_back(path[i]);
+        }
+        return full;
+    }
+
+    /**
+     * @brief Number of shortcut edges.
+     */
+    int size() const {
+        return chains.size();
+    }
+
+private:
+    map<pair<int, int>, vector<int>> chains; ///< (u, w) -> vertices between u and w
+
+    /**
+     * @brief Appends the interior of u->v (if it is a shortcut) to chain and forgets it.
+     */
+    void take(int u, int v, vector<int> &chain) {
+        auto it = chains.find(make_pair(u, v));
+        if (it == chains.end()) return;
+        chain.insert(chain.end(), it->second.begin(), it->second.end());
+        chains.erase(it);
+    }
+};
+
+/**
+ * @brief Checks whether a vertex has an outgoing edge to another.
+ */
+template <class T>
+bool hasEdgeTo(const Vertex<T> *u, const Vertex<T> *w) {
+    for (auto e : u->getAdj())
+        if (e->getDest() == w) return true;
+    return false;
+}
+
+/**
+ * @brief Contracts the maximal degree-2 chains of a graph.
+ * @details Vertices in keep (and parking vertices, if keepParking) are never removed,
+ * so they stay addressable by queries. Reachability and shortest distances between
+ * the remaining vertices are unchanged; the strongly connected component labels stay
+ * valid. Alternative routes (Routing's removePath) see a shortcut as one segment.
+ *
+ * @param g Pointer to the graph, contracted in place.
+ * @param chains Receives the interior of every shortcut created.
+ * @param keep Vertex IDs that must not be contracted.
+ * @param keepParking If true, parking vertices are kept as well.
+ * @return Number of vertices removed.
+ * @complexity O(V^2) with Graph::removeVertex's linear lookup; O(V + E) otherwise.
+ */
+inline int contractChains(Graph<int> *g, ChainMap &chains, const vector<int> &keep = {}, bool keepParking = true) {
+    unordered_set<int> kept(keep.begin(), keep.end());
+    vector<Vertex<int> *> work = g->getVertexSet();
+    unordered_set<Vertex<int> *> removed;
+    int contracted = 0;
+
+    while (!work.empty()) {
+        Vertex<int> *v = work.back();
+        work.pop_back();
+        if (removed.count(v) || kept.count(v->getInfo()) || (keepParking && v->hasParking())) continue;
+        vector<Edge<int> *> out = v->getAdj(), in = v->getIncoming();
+
+        if (out.size() == 1 && in.size() == 1) {
+            Vertex<int> *u = in[0]->getOrig(), *w = out[0]->getDest();
+            if (u == v || w == v || u == w || hasEdgeTo(u, w)) continue;
+            double weight = in[0]->getWeight() + out[0]->getWeight();
+            chains.join(u->getInfo(), v->getInfo(), w->getInfo());
+            u->addEdge(w, weight);
+            work.push_back(u);
+            work.push_back(w);
+        }
+        else if (out.size() == 2 && in.size() == 2) {
+            Vertex<int> *a = out[0]->getDest(), *b = out[1]->getDest();
+            if (a == b || a == v || b == v) continue;
+            Vertex<int> *x = in[0]->getOrig(), *y = in[1]->getOrig();
+            if (!((x == a && y == b) || (x == b && y == a))) continue;
+            if (hasEdgeTo(a, b) || hasEdgeTo(b, a)) continue;
+            Edge<int> *av = x == a ? in[0] : in[1], *bv = x == a ? in[1] : in[0];
+            chains.join(a->getInfo(), v->getInfo(), b->getInfo());
+            chains.join(b->getInfo(), v->getInfo(), a->getInfo());
+            a->addEdge(b, av->getWeight() + out[1]->getWeight());
+            b->addEdge(a, bv->getWeight() + out[0]->getWeight());
+            work.push_back(a);
+            work.push_back(b);
+        }
+        else continue;
+
+        removed.insert(v);
+        g->removeVertex(v->getInfo());
+        contracted++;
+    }
+    return contracted;
+}
+
+#endif //CHAINCONTRACTION_H
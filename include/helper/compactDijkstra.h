@@ -0,0 +1,78 @@
+/**
+ * @file compactDijkstra.h
+ * @brief Dijkstra's algorithm over a CompactGraph.
+ * @details The adjacency of a settled vertex is decoded on the fly while it is
+ * relaxed, so the graph is never expanded in memory. Distances are integers and match
+ * the ones computed by csrDijkstra.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef COMPACTDIJKSTRA_H
+#define COMPACTDIJKSTRA_H
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include "../data_structs/CompactGraph.h"
+#include "csrDijkstra.h"
+using namespace std;
+
+/**
+ * @brief Shortest paths from a source slot of a CompactGraph.
+ * @param g Compact graph.
+ * @param source Source slot.
+ * @param dist Receives slot -> distance (INT_INF if unreachable).
+ * @param pred Receives slot -> previous slot on the path (-1 for the source or unreachable).
+ * @complexity O((V + E) log V).
+ */
+template <class T>
+void compactDijkstra(const CompactGraph<T> &g, int source, vector<int> &dist, vector<int> &pred) {
+    int n = g.getNumVertex();
+    dist.assign(n, INT_INF);
+    pred.assign(n, -1);
+    if (source < 0 || source >= n) return;
+
+    typedef pair<int, int> Entry; // (distance, slot)
+    priority_queue<Entry, vector<Entry>, greater<Entry>> q;
+    dist[source] = 0;
+    q.push({0, source});
+    while (!q.empty()) {
+        Entry top = q.top();
+        q.pop();
+        int u = top.second, du = top.first;
+        if (du != dist[u]) continue; // stale entry
+        g.forEachEdge(u, [&](int v, int w) {
+            if (du + w < dist[v]) {
+                dist[v] = du + w;
+                pred[v] = u;
+                q.push({dist[v], v});
+            }
+        });
+    }
+}
+
+/**
+ * @brief Retrieves the path to a slot after compactDijkstra.
+ * @param g Compact graph.
+ * @param dist Distances from compactDijkstra.
+ * @param pred Predecessors from compactDijkstra.
+ * @param dest Destination slot.
+ * @param w Receives the path weight.
+ * @return Vertex contents of the path, empty if there is none.
+ * @complexity O(P), where P is the number of vertices in the path.
+ */
+template <class T>
+vector<T> compactGetPath(const CompactGraph<T> &g, const vector<int> &dist, const vector<int> &pred, int dest, int &w) {
+    vector<T> res;
+    if (dest < 0 || dest >= g.getNumVertex() || dist[dest] == INT_INF) return res;
+    w = dist[dest];
+    for (int v = dest; v != -1; v = pred[v])
+        res.push_back(g.getInfo(v));
+    reverse(res.begin(), res.end());
+    return res;
+}
+
+#endif //COMPACTDIJKSTRA_H
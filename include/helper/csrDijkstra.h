@@ -0,0 +1,209 @@
+/**
+ * @file csrDijkstra.h
+ * @brief Dijkstra's algorithm over a CSRGraph, with vectorized edge relaxation.
+ * @details A settled vertex relaxes its whole neighbour list at once: targets and
+ * weights are contiguous, so the tentative distances can be gathered, compared and
+ * masked 8 lanes at a time with AVX2. A scalar kernel is used when the CPU does not
+ * support AVX2; the kernel is chosen once at runtime. Distances are integers and
+ * match the ones computed by dijkstra in Dijkstra.h. Both functions accept any graph with
+ * the read interface of CSRGraph, such as a GraphLayer of a MultiLayerGraph.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef CSRDIJKSTRA_H
+#define CSRDIJKSTRA_H
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include "../data_structs/CSRGraph.h"
+#include "../data_structs/MultiLayerGraph.h"
+#include "searchControl.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CSR_HAS_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+#define INT_INF std::numeric_limits<int>::max()
+
+/**
+ * @brief Shortest-path tree over CSR slots.
+ */
+struct ShortestPathTree {
+    vector<int> dist;   ///< slot -> distance from the source (INT_INF if unreachable)
+    vector<int> parent; ///< slot -> edge ID used to reach it (-1 for the source or unreachable)
+};
+
+/**
+ * @brief Signature of a relaxation kernel.
+ * @details Relaxes edges [begin, end) leaving a vertex with distance du, updating dist
+ * and parent, and writes the slots whose distance improved into improved.
+ * @return Number of improved slots.
+ */
+typedef int (*RelaxKernel)(const int *targets, const int *weights, int begin, int end, int du,
+                           int *dist, int *parent, int *improved);
+
+/**
+ * @brief Scalar relaxation kernel.
+ * @complexity O(d), where d is the number of edges.
+ */
+inline int relaxScalar(const int *targets, const int *weights, int begin, int end, int du,
+                       int *dist, int *parent, int *improved) {
+    int count = 0;
+    for (int e = begin; e < end; e++) {
+        int nd = du + weights[e];
+        int t = targets[e];
+        if (nd < dist[t]) {
+            dist[t] = nd;
+            parent[t] = e;
+            improved[count++] = t;
+        }
+    }
+    return count;
+}
+
+#ifdef CSR_HAS_AVX2_KERNEL
+/**
+ * @brief AVX2 relaxation kernel.
+ * @details Gathers 8 tentative distances at a time and compares them with du + weight.
+ * Lanes that improve are written back one by one, re-checking the distance so that
+ * parallel edges to the same target inside a block are handled correctly.
+ * @complexity O(d), where d is the number of edges.
+ */
+__attribute__((target("avx2")))
+inline int relaxAVX2(const int *targets, const int *weights, int begin, int end, int du,
+                     int *dist, int *parent, int *improved) {
+    int count = 0;
+    int e = begin;
+    const __m256i base = _mm256_set1_epi32(du);
+    for (; e + 8 <= end; e += 8) {
+        __m256i t = _mm256_loadu_si256((const __m256i *) (targets + e));
+        __m256i w = _mm256_loadu_si256((const __m256i *) (weights + e));
+        __m256i nd = _mm256_add_epi32(base, w);
+        __m256i cur = _mm256_i32gather_epi32(dist, t, 4);
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(cur, nd)));
+        while (mask) {
+            int lane = __builtin_ctz(mask);
+            mask &= mask - 1;
+            int k = e + lane;
+            int d = du + weights[k];
+            if (d < dist[targets[k]]) {
+                dist[targets[k]] = d;
+                parent[targets[k]] = k;
+                improved[count++] = targets[k];
+            }
+        }
+    }
+    return count + relaxScalar(targets, weights, e, end, du, dist, parent, improved + count);
+}
+#endif
+
+/**
+ * @brief Picks the fastest relaxation kernel supported by the running CPU.
+ * @complexity O(1).
+ */
+inline RelaxKernel selectRelaxKernel() {
+#ifdef CSR_HAS_AVX2_KERNEL
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return relaxAVX2;
+#endif
+    return relaxScalar;
+}
+
+/**
+ * @brief Runs Dijkstra's algorithm from a slot of a CSRGraph (or GraphLayer).
+ * @details Uses a binary heap with lazy deletion and relaxes each settled vertex's
+ * neighbour list with the given kernel (the one selected at runtime by default).
+ *
+ * @tparam G CSRGraph or GraphLayer.
+ * @param g CSR graph.
+ * @param source Source slot.
+ * @param tree Receives distances and parent edges.
+ * @param kernel Relaxation kernel; nullptr selects one for the running CPU.
+ * @param control Deadline and cancellation of the search (nullptr for none); a stopped
+ * search leaves exact distances on settled slots and tentative ones elsewhere.
+ * @return False if the search was stopped by control before it finished.
+ * @complexity O((V + E) log V).
+ */
+template <class G>
+bool csrDijkstra(const G &g, int source, ShortestPathTree &tree, RelaxKernel kernel = nullptr,
+                 SearchControl *control = nullptr) {
+    MemoryScope scope(MEM_SEARCH);
+    static const RelaxKernel best = selectRelaxKernel();
+    if (kernel == nullptr) kernel = best;
+
+    int n = g.getNumVertex();
+    tree.dist.assign(n, INT_INF);
+    tree.parent.assign(n, -1);
+    if (source < 0 || source >= n) return true;
+
+    const int *targets = g.getTargets().data();
+    const int *weights = g.getWeights().data();
+    vector<int> improved;
+    vector<bool> settled(n, false);
+
+    typedef pair<int, int> Entry; // (distance, slot)
+    priority_queue<Entry, vector<Entry>, greater<Entry>> q;
+    tree.dist[source] = 0;
+    q.push({0, source});
+    while (!q.empty()) {
+        Entry top = q.top();
+        q.pop();
+        int u = top.second;
+        if (settled[u]) continue;
+        if (control != nullptr && control->tick()) return false;
+        settled[u] = true;
+
+        int begin = g.edgeBegin(u), end = g.edgeEnd(u);
+        if ((int) improved.size() < end - begin) improved.resize(end - begin);
+        int count = kernel(targets, weights, begin, end, top.first,
+                           tree.dist.data(), tree.parent.data(), improved.data());
+        for (int i = 0; i < count; i++) {
+            q.push({tree.dist[improved[i]], improved[i]});
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Retrieves the shortest path to a slot from a ShortestPathTree.
+ * @details Same output as getPath in Dijkstra.h: vertex IDs from source to destination.
+ *
+ * @param g CSR graph the tree was computed on.
+ * @param tree Shortest-path tree.
+ * @param dest Destination slot.
+ * @param w Receives the total path weight.
+ * @return Vertex IDs of the path, empty if there is none.
+ * @complexity O(P), where P is the number of vertices in the path.
+ */
+template <class G>
+auto csrGetPath(const G &g, const ShortestPathTree &tree, int dest, int &w) -> vector<decltype(g.getInfo(0))> {
+    vector<decltype(g.getInfo(0))> res;
+    if (dest < 0 || dest >= g.getNumVertex() || tree.dist[dest] == INT_INF) {
+        return res;
+    }
+    w = tree.dist[dest];
+    int v = dest;
+    vector<int> rev;
+    for (int e = tree.parent[v]; e != -1; e = tree.parent[v]) {
+        rev.push_back(v);
+        // the origin of edge e is the slot whose edge range contains e
+        const vector<int> &off = g.getOffsets();
+        v = upper_bound(off.begin(), off.end(), e) - off.begin() - 1;
+    }
+    rev.push_back(v);
+    for (auto it = rev.rbegin(); it != rev.rend(); it++) {
+        res.push_back(g.getInfo(*it));
+    }
+    return res;
+}
+
+#endif //CSRDIJKSTRA_H
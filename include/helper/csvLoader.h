@@ -8,17 +8,46 @@
  */
 #ifndef CSVLOADER_H
 #define CSVLOADER_H
-#include <iostream>
-#include <fstream>
-#include <sstream>
+#include <string>
 #include <unordered_map>
 #include "../data_structs/Graph.h"
+#include "../data_structs/MultiLayerGraph.h"
 
 using namespace std;
+/**
+ * @brief Parses a row of Locations.csv ("Location,Id,Code,Parking").
+ * @details Every loader, including the incremental reload of hotReload.h, parses
+ * location rows with this function and skips the rows it rejects.
+ *
+ * @param line Row of the file.
+ * @param code Receives the location code (also when the row is rejected).
+ * @param id Receives the location ID.
+ * @param parking Receives the parking flag.
+ * @return False if the ID or the parking flag is not an integer.
+ * @complexity O(L) for L being the length of the row.
+ */
+bool parseLocationRow(const string& line, string& code, int& id, bool& parking);
+/**
+ * @brief Parses a row of Distances.csv ("Location1,Location2,Driving,Walking").
+ * @details Every loader, including the incremental reload of hotReload.h, parses
+ * segment rows with this function and skips the rows it rejects, whole: a row with
+ * one invalid time adds neither of its edges.
+ *
+ * @param line Row of the file.
+ * @param src Receives the code of the first location.
+ * @param dest Receives the code of the second location.
+ * @param driving Receives the driving time, or -1 if the segment is cut ('X').
+ * @param walking Receives the walking time, or -1 if the segment is cut ('X').
+ * @return False if a time is neither a non-negative integer nor 'X'.
+ * @complexity O(L) for L being the length of the row.
+ */
+bool parseDistanceRow(const string& line, string& src, string& dest, int& driving, int& walking);
 /**
  * @brief Loads the distances from the data file.
  * @details Loads the distances from the csv file into the
  * respective graphs (drive and walk), updating its edges.
+ * Rows with an unknown location or a time that is neither a
+ * non-negative integer nor 'X' are reported and skipped.
  *
  * @param filePath Path to the csv file containing the distances.
  * @param locations Map of location names to their respective IDs.
@@ -26,41 +55,13 @@ using namespace std;
  * @param walk Graph containing the walking distances.
  * @complexity O(N) for N being the number of lines in the csv file.
  */
-void loadDistances(const string& filePath, unordered_map<string, string>& locations, Graph<int>& drive, Graph<int>& walk) {
-    ifstream file(filePath);
-    string line, src, dest, driving, walking;
-
-    if (!file.is_open()) {
-        cerr << "Error opening file: " << filePath << endl;
-        return;
-    }
-
-    getline(file, line); // Skip header
-    while (getline(file, line)) {
-        stringstream ss(line);
-        getline(ss, src, ',');  // Read **source location name**
-        getline(ss, dest, ','); // Read **destination location name**
-        getline(ss, driving, ',');
-        getline(ss, walking, ',');
-
-        int src_id = stoi(locations[src]);
-        int dest_id = stoi(locations[dest]);
-
-        //Handle the driving and walking routes that are cut ('X' in the csv)
-        if (driving != "X") {
-            drive.addEdge(src_id, dest_id, stoi(driving));
-        }
-        if (walking != "X") {
-            walk.addEdge(src_id, dest_id, stoi(walking));
-        }
-    }
-    file.close();
-}
+void loadDistances(const string& filePath, unordered_map<string, string>& locations, Graph<int>& drive, Graph<int>& walk);
 /**
  * @brief Loads the locations from the data file.
  * @details Loads the locations from the csv file into the
  * respective graphs (g1 and g2), creating its vertices
- * with the ids of each location.
+ * with the ids of each location. Rows with an invalid ID or
+ * parking flag are reported and skipped.
  *
  * @param filePath Path to the csv file containing the distances.
  * @param g1 Graph containing the driving distances.
@@ -68,46 +69,7 @@ void loadDistances(const string& filePath, unordered_map<string, string>& locati
  * @param locations Map of location names to their respective IDs.
  * @complexity O(N) for N being the number of lines in the csv file.
  */
-void loadLocations(const string& filePath, Graph<int>& g1, Graph<int>& g2, unordered_map<string, string>& locations) {
-    ifstream file(filePath);
-    string line, loc, code, loc_id;
-    int parking, id;
-
-    if (!file.is_open()) {
-        cerr << "Error opening file: " << filePath << endl;
-        return;
-    }
-
-    getline(file, line); // skip header
-    while (getline(file, line)) {
-        stringstream ss(line);
-        getline(ss, loc, ',');
-        getline(ss, loc_id, ',');
-        getline(ss, code, ',');
-        ss >> parking;
-
-        locations[code] = loc_id;
-        id = stoi(loc_id);
-        g1.addVertex(id);
-        g2.addVertex(id);
-        g1.findVertex(id)->setParking(parking);
-        g2.findVertex(id)->setParking(parking);
-    }
-
-    file.close();
-}
-void loadGraphs(Graph<int>& drive, Graph<int>& walk) {
-    string distancesFile = "data/Distances.csv";
-    string locationsFile = "data/Locations.csv";
-
-    unordered_map<string, string> locations;
-
-    // Load locations first (ensures vertices exist)
-    loadLocations(locationsFile, drive, walk, locations);
-
-    // Load distances (now vertices exist, so edges can be added safely)
-    loadDistances(distancesFile, locations, drive, walk);
-}
+void loadLocations(const string& filePath, Graph<int>& g1, Graph<int>& g2, unordered_map<string, string>& locations);
 /**
  * @brief Main call of the csv loaders
  * @details Calls both loadLocations and loadDistances
@@ -115,6 +77,32 @@ void loadGraphs(Graph<int>& drive, Graph<int>& walk) {
  *
  * @param drive Graph containing the driving distances.
  * @param walk Graph containing the walking distances.
+ * @param codes If not null, receives the map of location codes to their IDs.
  * @complexity O(N) since the function calls 2 funtions that have complexity O(N).
  */
+void loadGraphs(Graph<int>& drive, Graph<int>& walk, unordered_map<string, string>* codes = nullptr);
+/**
+ * @brief Layer indexes of the network filled by loadNetwork.
+ */
+enum NetworkLayer {
+    LAYER_DRIVE, ///< driving distances
+    LAYER_WALK   ///< walking distances
+};
+/**
+ * @brief Loads both csv files into a MultiLayerGraph.
+ * @details Each location is stored once, in the shared vertex table, and each row of
+ * the distances file is parsed once and added to the driving and walking layers (cut
+ * segments, 'X' in the csv, are left out of their layer). Slots follow the order of
+ * the locations file and edges the order of the distances file, as in the CSRGraph of
+ * the graphs filled by loadGraphs. Rows are parsed by the same code as loadLocations
+ * and loadDistances, so the same invalid rows are reported and skipped.
+ *
+ * @param locationsFile Path to the csv file containing the locations.
+ * @param distancesFile Path to the csv file containing the distances.
+ * @param g Receives the locations and the LAYER_DRIVE and LAYER_WALK layers, built.
+ * @param codes If not null, receives the map of location codes to their IDs.
+ * @complexity O(N) for N being the number of lines in the csv files.
+ */
+void loadNetwork(const string& locationsFile, const string& distancesFile, MultiLayerGraph<int>& g,
+                 unordered_map<string, string>* codes = nullptr);
 #endif //CSVLOADER_H
@@ -0,0 +1,396 @@
+/**
+ * @file distanceTable.h
+ * @brief Precomputed all-pairs distance and next-hop table.
+ * @details For networks of the size of data/ (about 1,300 locations) a full table
+ * fits in a few megabytes and turns every query into a lookup: the distance is one
+ * read and the path is rebuilt by following next hops, so a query costs O(path length).
+ *
+ * The table is built either with one Dijkstra per source (best for sparse graphs) or
+ * with a cache-blocked Floyd-Warshall, both spread over several threads. Rows are
+ * stored in flat arrays in slot order. After the build, distances are narrowed to
+ * 16 bits when every finite distance fits, and next hops when there are fewer than
+ * 65535 vertices.
+ *
+ * File layout (little-endian): magic "APT1", version, V, distance bytes (2 or 4),
+ * next-hop bytes (2 or 4) as uint32; then slot -> vertex ID [V] as uint32, distances
+ * [V*V] and next hops [V*V]. Unreachable pairs hold the maximum value of their type.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef DISTANCETABLE_H
+#define DISTANCETABLE_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+#include "../data_structs/CSRGraph.h"
+#include "csrDijkstra.h"
+using namespace std;
+
+#define DISTANCE_TABLE_MAGIC 0x31545041u // "APT1"
+#define DISTANCE_TABLE_VERSION 1u
+#define FW_BLOCK 64
+
+/**
+ * @brief How the table is computed.
+ */
+enum TableMethod {
+    TABLE_AUTO,           ///< Dijkstra per source on sparse graphs, Floyd-Warshall otherwise
+    TABLE_SSSP,           ///< one csrDijkstra per source
+    TABLE_FLOYD_WARSHALL  ///< cache-blocked Floyd-Warshall
+};
+
+/**
+ * @brief All-pairs distances and next hops of a CSRGraph.
+ */
+class DistanceTable {
+public:
+    /*
+     * Computes the table of g. threads = 0 uses every hardware thread.
+     */
+    void build(const CSRGraph<int> &g, TableMethod method = TABLE_AUTO, unsigned threads = 0);
+
+    /*
+     * Saves the table to a binary file. Returns false on failure.
+     */
+    bool save(const string &path) const;
+    /*
+     * Loads a file written by save. Returns false if it is missing or invalid.
+     */
+    bool load(const string &path);
+
+    int getNumVertex() const;
+    int findSlot(int id) const; // -1 if unknown
+
+    /*
+     * Distance between two slots; INT_INF if unreachable.
+     */
+    int distanceSlots(int s, int t) const;
+    /*
+     * Slot that follows s on the shortest path to t; -1 if unreachable.
+     */
+    int nextHop(int s, int t) const;
+
+    /*
+     * Distance between two vertex IDs; INT_INF if unreachable or unknown.
+     */
+    int distance(int source, int dest) const;
+    /*
+     * Shortest path between two vertex IDs; empty if there is none.
+     */
+    vector<int> path(int source, int dest, int &w) const;
+
+    size_t memoryBytes() const;
+
+protected:
+    int n = 0;
+    vector<int> ids;                 // slot -> vertex ID
+    unordered_map<int, int> slotOf;  // vertex ID -> slot
+    vector<uint16_t> dist16, hop16;  // used when the values fit in 16 bits
+    vector<uint32_t> dist32, hop32;  // used otherwise
+
+    void buildSSSP(const CSRGraph<int> &g, vector<uint32_t> &dist, vector<uint32_t> &hop, unsigned threads);
+    void buildFloydWarshall(const CSRGraph<int> &g, vector<uint32_t> &dist, vector<uint32_t> &hop, unsigned threads);
+    void store(vector<uint32_t> &dist, vector<uint32_t> &hop);
+};
+
+inline int DistanceTable::getNumVertex() const {
+    return n;
+}
+
+inline int DistanceTable::findSlot(int id) const {
+    auto it = slotOf.find(id);
+    return it == slotOf.end() ? -1 : it->second;
+}
+
+inline int DistanceTable::distanceSlots(int s, int t) const {
+    size_t k = (size_t) s * n + t;
+    if (!dist16.empty()) return dist16[k] == UINT16_MAX ? INT_INF : dist16[k];
+    return dist32[k] == UINT32_MAX ? INT_INF : (int) dist32[k];
+}
+
+inline int DistanceTable::nextHop(int s, int t) const {
+    size_t k = (size_t) s * n + t;
+    if (!hop16.empty()) return hop16[k] == UINT16_MAX ? -1 : hop16[k];
+    return hop32[k] == UINT32_MAX ? -1 : (int) hop32[k];
+}
+
+inline int DistanceTable::distance(int source, int dest) const {
+    int s = findSlot(source), t = findSlot(dest);
+    if (s < 0 || t < 0) return INT_INF;
+    return distanceSlots(s, t);
+}
+
+/**
+ * @brief Rebuilds a path by following next hops.
+ * @complexity O(P), where P is the number of vertices in the path.
+ */
+inline vector<int> DistanceTable::path(int source, int dest, int &w) const {
+    vector<int> res;
+    int s = findSlot(source), t = findSlot(dest);
+    if (s < 0 || t < 0 || distanceSlots(s, t) == INT_INF) return res;
+    w = distanceSlots(s, t);
+    res.push_back(ids[s]);
+    for (int v = s; v != t;) {
+        v = nextHop(v, t);
+        res.push_back(ids[v]);
+    }
+    return res;
+}
+
+inline size_t DistanceTable::memoryBytes() const {
+    return sizeof(*this) + ids.capacity() * sizeof(int) + slotOf.size() * 2 * sizeof(int) +
+           dist16.capacity() * 2 + hop16.capacity() * 2 + dist32.capacity() * 4 + hop32.capacity() * 4;
+}
+
+/**
+ * @brief Runs f(worker) on the given number of threads and waits for all of them.
+ */
+template <class F>
+void runWorkers(unsigned threads, F f) {
+    vector<thread> pool;
+    for (unsigned k = 1; k < threads; k++)
+        pool.emplace_back(f, k);
+    f(0);
+    for (auto &t : pool) t.join();
+}
+
+/**
+ * @brief Fills the table rows with one csrDijkstra per source.
+ * @details Threads take sources from a shared counter. The next hop of every target
+ * is the first vertex after the source on its tree path, found by walking up the tree
+ * until a vertex whose next hop is already known.
+ * @complexity O(V (V + E) log V / threads).
+ */
+inline void DistanceTable::buildSSSP(const CSRGraph<int> &g, vector<uint32_t> &dist, vector<uint32_t> &hop,
+                                     unsigned threads) {
+    const vector<int> &off = g.getOffsets();
+    atomic<int> nextSource(0);
+    runWorkers(threads, [&](unsigned) {
+        ShortestPathTree tree;
+        vector<int> stack;
+        for (int s = nextSource++; s < n; s = nextSource++) {
+            csrDijkstra(g, s, tree);
+            uint32_t *d = &dist[(size_t) s * n], *h = &hop[(size_t) s * n];
+            for (int t = 0; t < n; t++) {
+                d[t] = tree.dist[t] == INT_INF ? UINT32_MAX : (uint32_t) tree.dist[t];
+                h[t] = UINT32_MAX;
+            }
+            h[s] = s;
+            for (int t = 0; t < n; t++) {
+                if (d[t] == UINT32_MAX || h[t] != UINT32_MAX) continue;
+                int v = t;
+                while (h[v] == UINT32_MAX) { // climb until a known next hop
+                    stack.push_back(v);
+                    v = upper_bound(off.begin(), off.end(), tree.parent[v]) - off.begin() - 1;
+                }
+                uint32_t first = h[v];
+                while (!stack.empty()) {
+                    int u = stack.back();
+                    stack.pop_back();
+                    if (v == s) first = u; // u follows the source directly
+                    h[u] = first;
+                    v = u;
+                }
+            }
+        }
+    });
+}
+
+/**
+ * @brief Fills the table with a cache-blocked Floyd-Warshall.
+ * @details The matrix is split into FW_BLOCK x FW_BLOCK tiles. For each diagonal tile
+ * k: the tile itself is updated, then the tiles of row and column k (in parallel), then
+ * every other tile (in parallel, by rows of tiles). Each update only touches three
+ * tiles, which stay in cache.
+ * @complexity O(V^3 / threads).
+ */
+inline void DistanceTable::buildFloydWarshall(const CSRGraph<int> &g, vector<uint32_t> &dist,
+                                              vector<uint32_t> &hop, unsigned threads) {
+    const uint32_t inf = 0x3fffffffu; // two of them still fit in 32 bits
+    for (int s = 0; s < n; s++) {
+        for (int t = 0; t < n; t++) {
+            dist[(size_t) s * n + t] = s == t ? 0 : inf;
+            hop[(size_t) s * n + t] = s == t ? s : UINT32_MAX;
+        }
+        for (int e = g.edgeBegin(s); e < g.edgeEnd(s); e++) {
+            size_t k = (size_t) s * n + g.getTarget(e);
+            if ((uint32_t) g.getWeight(e) < dist[k]) {
+                dist[k] = g.getWeight(e);
+                hop[k] = g.getTarget(e);
+            }
+        }
+    }
+
+    int blocks = (n + FW_BLOCK - 1) / FW_BLOCK;
+    auto tile = [&](int bi, int bj, int bk) {
+        int i1 = min(n, (bi + 1) * FW_BLOCK), j0 = bj * FW_BLOCK, j1 = min(n, (bj + 1) * FW_BLOCK);
+        int k1 = min(n, (bk + 1) * FW_BLOCK);
+        for (int k = bk * FW_BLOCK; k < k1; k++) {
+            const uint32_t *dk = &dist[(size_t) k * n];
+            for (int i = bi * FW_BLOCK; i < i1; i++) {
+                uint32_t *di = &dist[(size_t) i * n], *hi = &hop[(size_t) i * n];
+                uint32_t dik = di[k];
+                if (dik >= inf) continue;
+                for (int j = j0; j < j1; j++) {
+                    if (dik + dk[j] < di[j]) {
+                        di[j] = dik + dk[j];
+                        hi[j] = hi[k];
+                    }
+                }
+            }
+        }
+    };
+    for (int bk = 0; bk < blocks; bk++) {
+        tile(bk, bk, bk);
+        atomic<int> next(0);
+        runWorkers(threads, [&](unsigned) {
+            for (int b = next++; b < blocks; b = next++) {
+                if (b == bk) continue;
+                tile(bk, b, bk);
+                tile(b, bk, bk);
+            }
+        });
+        next = 0;
+        runWorkers(threads, [&](unsigned) {
+            for (int bi = next++; bi < blocks; bi = next++) {
+                if (bi == bk) continue;
+                for (int bj = 0; bj < blocks; bj++)
+                    if (bj != bk) tile(bi, bj, bk);
+            }
+        });
+    }
+    for (auto &d : dist)
+        if (d >= inf) d = UINT32_MAX;
+}
+
+/**
+ * @brief Keeps the computed arrays, narrowed to 16 bits when the values fit.
+ * @complexity O(V^2).
+ */
+inline void DistanceTable::store(vector<uint32_t> &dist, vector<uint32_t> &hop) {
+    dist16.clear();
+    hop16.clear();
+    dist32.clear();
+    hop32.clear();
+    bool small = true;
+    for (uint32_t d : dist)
+        if (d != UINT32_MAX && d >= UINT16_MAX) small = false;
+    if (small) {
+        dist16.resize(dist.size());
+        for (size_t k = 0; k < dist.size(); k++) dist16[k] = dist[k] == UINT32_MAX ? UINT16_MAX : dist[k];
+        vector<uint32_t>().swap(dist);
+    }
+    else dist32.swap(dist);
+    if (n < UINT16_MAX) {
+        hop16.resize(hop.size());
+        for (size_t k = 0; k < hop.size(); k++) hop16[k] = hop[k] == UINT32_MAX ? UINT16_MAX : hop[k];
+        vector<uint32_t>().swap(hop);
+    }
+    else hop32.swap(hop);
+}
+
+/**
+ * @brief Computes the table.
+ * @details TABLE_AUTO picks Dijkstra per source when E log V < V^2, i.e. on every
+ * road-like network, and Floyd-Warshall on dense graphs.
+ * @complexity O(V (V + E) log V) or O(V^3), divided by the number of threads.
+ */
+inline void DistanceTable::build(const CSRGraph<int> &g, TableMethod method, unsigned threads) {
+    n = g.getNumVertex();
+    ids.resize(n);
+    slotOf.clear();
+    for (int s = 0; s < n; s++) {
+        ids[s] = g.getInfo(s);
+        slotOf[ids[s]] = s;
+    }
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    if (method == TABLE_AUTO) {
+        double logV = n > 1 ? log2((double) n) : 1.0;
+        method = (double) g.getNumEdges() * logV < (double) n * n ? TABLE_SSSP : TABLE_FLOYD_WARSHALL;
+    }
+
+    vector<uint32_t> dist((size_t) n * n), hop((size_t) n * n);
+    if (method == TABLE_SSSP) buildSSSP(g, dist, hop, threads);
+    else buildFloydWarshall(g, dist, hop, threads);
+    store(dist, hop);
+}
+
+/**
+ * @brief Writes the table to a binary file.
+ * @complexity O(V^2).
+ */
+inline bool DistanceTable::save(const string &path) const {
+    FILE *f = fopen(path.c_str(), "wb");
+    if (f == nullptr) return false;
+    size_t cells = (size_t) n * n;
+    uint32_t header[5] = {DISTANCE_TABLE_MAGIC, DISTANCE_TABLE_VERSION, (uint32_t) n,
+                          dist16.empty() ? 4u : 2u, hop16.empty() ? 4u : 2u};
+    bool ok = fwrite(header, sizeof(uint32_t), 5, f) == 5;
+    ok = ok && fwrite(ids.data(), sizeof(int), n, f) == (size_t) n;
+    if (!dist16.empty()) ok = ok && fwrite(dist16.data(), 2, cells, f) == cells;
+    else ok = ok && fwrite(dist32.data(), 4, cells, f) == cells;
+    if (!hop16.empty()) ok = ok && fwrite(hop16.data(), 2, cells, f) == cells;
+    else ok = ok && fwrite(hop32.data(), 4, cells, f) == cells;
+    return fclose(f) == 0 && ok;
+}
+
+/**
+ * @brief Reads a table written by save.
+ * @details The header is checked against the file size before anything is allocated,
+ * so a corrupt vertex count is rejected instead of sizing the arrays.
+ * @complexity O(V^2).
+ */
+inline bool DistanceTable::load(const string &path) {
+    FILE *f = fopen(path.c_str(), "rb");
+    if (f == nullptr) return false;
+    uint32_t header[5];
+    bool ok = fread(header, sizeof(uint32_t), 5, f) == 5 && header[0] == DISTANCE_TABLE_MAGIC &&
+              header[1] == DISTANCE_TABLE_VERSION && (header[3] == 2 || header[3] == 4) &&
+              (header[4] == 2 || header[4] == 4);
+    long size = ok && fseek(f, 0, SEEK_END) == 0 ? ftell(f) : -1;
+    if (ok) {
+        // size = 20 + 4 V + (distance + next-hop bytes) V^2, without overflowing
+        uint64_t v = header[2], cellBytes = header[3] + header[4];
+        uint64_t rest = size < 20 ? 0 : (uint64_t) size - 20;
+        ok = size >= 20 && v <= rest / 4 && (rest - 4 * v) % cellBytes == 0 && v * v == (rest - 4 * v) / cellBytes &&
+             fseek(f, 20, SEEK_SET) == 0;
+    }
+    if (ok) {
+        n = header[2];
+        size_t cells = (size_t) n * n;
+        ids.resize(n);
+        dist16.clear();
+        dist32.clear();
+        hop16.clear();
+        hop32.clear();
+        ok = fread(ids.data(), sizeof(int), n, f) == (size_t) n;
+        if (header[3] == 2) dist16.resize(cells), ok = ok && fread(dist16.data(), 2, cells, f) == cells;
+        else dist32.resize(cells), ok = ok && fread(dist32.data(), 4, cells, f) == cells;
+        if (header[4] == 2) hop16.resize(cells), ok = ok && fread(hop16.data(), 2, cells, f) == cells;
+        else hop32.resize(cells), ok = ok && fread(hop32.data(), 4, cells, f) == cells;
+        ok = ok && fgetc(f) == EOF;
+        slotOf.clear();
+        for (int s = 0; ok && s < n; s++) slotOf[ids[s]] = s;
+    }
+    fclose(f);
+    if (!ok) {
+        n = 0;
+        ids.clear();
+        slotOf.clear();
+        dist16.clear();
+        dist32.clear();
+        hop16.clear();
+        hop32.clear();
+    }
+    return ok;
+}
+
+#endif //DISTANCETABLE_H
@@ -0,0 +1,212 @@
+/**
+ * @file embeddedRouting.h
+ * @brief Routing on a network compiled into the binary.
+ * @details gen-network turns data/Locations.csv and data/Distances.csv into a header
+ * of constexpr arrays: CSR offsets, targets and weights for driving and walking, the
+ * ID and code of every slot, a parking bitset and an ID lookup table, tied together by
+ * an EmbeddedNetwork constant (see the embedded target of the Makefile). Starting a
+ * program on it parses nothing and allocates nothing.
+ *
+ * The sizes are template parameters, so EmbeddedSearch holds its distance, predecessor
+ * and heap arrays inline with sizes fixed at compile time: a search never allocates,
+ * and one EmbeddedSearch can be reused for every query of a thread. Routes follow the
+ * rules of Routing and avoidRouting (the alternative route avoids the interior
+ * vertices of the best one); among routes of equal weight, the one chosen may differ.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef EMBEDDEDROUTING_H
+#define EMBEDDEDROUTING_H
+
+#include <vector>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include "csrDijkstra.h"
+#include "queryParser.h"
+#include "batchPlanner.h"
+using namespace std;
+
+/**
+ * @brief CSR arrays of one transport mode, with N vertices and E edges.
+ */
+template <int N, int E>
+struct EmbeddedGraph {
+    const int *offsets; ///< size N + 1
+    const int *targets; ///< size E, destination slot of every edge
+    const int *weights; ///< size E
+};
+
+/**
+ * @brief A network compiled into the binary: N locations, ED driving and EW walking segments.
+ */
+template <int N, int ED, int EW>
+struct EmbeddedNetwork {
+    const int *ids;                 ///< slot -> location ID
+    const char *const *codes;       ///< slot -> location code
+    const unsigned char *parking;   ///< parking bitset, bit s of byte s / 8
+    const int *sortedIds;           ///< location IDs in increasing order
+    const int *sortedSlots;         ///< slot of each ID of sortedIds
+    EmbeddedGraph<N, ED> drive;
+    EmbeddedGraph<N, EW> walk;
+
+    /**
+     * @brief Slot of a location ID, or -1 if there is none.
+     * @complexity O(log N).
+     */
+    int findSlot(int id) const {
+        const int *it = lower_bound(sortedIds, sortedIds + N, id);
+        return it != sortedIds + N && *it == id ? sortedSlots[it - sortedIds] : -1;
+    }
+
+    bool hasParking(int slot) const {
+        return (parking[slot >> 3] >> (slot & 7)) & 1;
+    }
+};
+
+/**
+ * @brief Fixed-size search state over an EmbeddedGraph<N, E>.
+ * @details Blocked slots and edges are skipped by the search, as if they had been
+ * removed; they are cleared with clearBlocks.
+ */
+template <int N, int E>
+class EmbeddedSearch {
+public:
+    EmbeddedSearch() {
+        clearBlocks();
+    }
+
+    void clearBlocks() {
+        memset(blockedSlot, 0, sizeof(blockedSlot));
+        memset(blockedEdge, 0, sizeof(blockedEdge));
+    }
+
+    void blockSlot(int s) {
+        blockedSlot[s] = 1;
+    }
+
+    /**
+     * @brief Blocks every edge from slot a to slot b.
+     */
+    void blockSegment(const EmbeddedGraph<N, E> &g, int a, int b) {
+        for (int e = g.offsets[a]; e < g.offsets[a + 1]; e++)
+            if (g.targets[e] == b) blockedEdge[e] = 1;
+    }
+
+    /**
+     * @brief Shortest paths from a source slot, skipping blocked slots and edges.
+     * @complexity O((V + E) log E), without allocating.
+     */
+    void run(const EmbeddedGraph<N, E> &g, int source) {
+        for (int v = 0; v < N; v++) {
+            dist[v] = INT_INF;
+            pred[v] = -1;
+        }
+        heapSize = 0;
+        if (source < 0 || blockedSlot[source]) return;
+        dist[source] = 0;
+        push(0, source);
+        while (heapSize > 0) {
+            pair<int, int> top = heap[0];
+            pop_heap(heap, heap + heapSize--, greater<pair<int, int>>());
+            int u = top.second;
+            if (top.first != dist[u]) continue; // stale entry
+            for (int e = g.offsets[u]; e < g.offsets[u + 1]; e++) {
+                int v = g.targets[e];
+                if (blockedEdge[e] || blockedSlot[v]) continue;
+                if (top.first + g.weights[e] < dist[v]) {
+                    dist[v] = top.first + g.weights[e];
+                    pred[v] = u;
+                    push(dist[v], v);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Route of the last search to a slot, as location IDs.
+     * @return Empty if the slot was not reached; w is then left unchanged.
+     */
+    vector<int> path(const int *ids, int dest, int &w) const {
+        vector<int> res;
+        if (dest < 0 || dist[dest] == INT_INF) return res;
+        w = dist[dest];
+        for (int v = dest; v != -1; v = pred[v]) res.push_back(ids[v]);
+        reverse(res.begin(), res.end());
+        return res;
+    }
+
+private:
+    int dist[N];
+    int pred[N];
+    unsigned char blockedSlot[N];
+    unsigned char blockedEdge[E > 0 ? E : 1];
+    pair<int, int> heap[E + 1]; // lazy deletion: at most one entry per relaxed edge, plus the source
+    int heapSize = 0;
+
+    void push(int d, int v) {
+        heap[heapSize++] = make_pair(d, v);
+        push_heap(heap, heap + heapSize, greater<pair<int, int>>());
+    }
+};
+
+/**
+ * @brief Answers a query on the driving graph of an embedded network.
+ * @details Unrestricted queries get the best route and the alternative route without
+ * its interior vertices; restricted ones avoid their nodes and segments and pass
+ * through their include node. Unknown IDs give empty routes.
+ *
+ * @param net Embedded network.
+ * @param search Search state to use (its blocks are cleared).
+ * @param q Query to answer.
+ * @return The routes, in the same form as answerQuery.
+ * @complexity O((V + E) log E) per search, at most two searches.
+ */
+template <int N, int ED, int EW>
+QueryAnswer embeddedAnswer(const EmbeddedNetwork<N, ED, EW> &net, EmbeddedSearch<N, ED> &search,
+                           const RouteQuery &q) {
+    QueryAnswer a;
+    const EmbeddedGraph<N, ED> &g = net.drive;
+    int s = net.findSlot(q.source), t = net.findSlot(q.destination);
+    search.clearBlocks();
+    if (s < 0 || t < 0) return a;
+
+    if (!q.isRestricted()) {
+        search.run(g, s);
+        a.primPath = search.path(net.ids, t, a.primW);
+        if (a.primPath.empty()) return a;
+        for (size_t i = 1; i + 1 < a.primPath.size(); i++) search.blockSlot(net.findSlot(a.primPath[i]));
+        search.run(g, s);
+        a.secPath = search.path(net.ids, t, a.secW);
+        return a;
+    }
+
+    for (int id : q.avoidNodes) {
+        int v = net.findSlot(id);
+        if (v >= 0) search.blockSlot(v);
+    }
+    for (auto &seg : q.avoidSegments) {
+        int u = net.findSlot(seg.first), v = net.findSlot(seg.second);
+        if (u >= 0 && v >= 0) search.blockSegment(g, u, v);
+    }
+    if (q.includeNode == 0) {
+        search.run(g, s);
+        a.primPath = search.path(net.ids, t, a.primW);
+        return a;
+    }
+    int inc = net.findSlot(q.includeNode), w1 = 0, w2 = 0;
+    search.run(g, s);
+    vector<int> first = search.path(net.ids, inc, w1);
+    if (first.empty()) return a;
+    search.run(g, inc);
+    vector<int> second = search.path(net.ids, t, w2);
+    if (second.empty()) return a;
+    a.primPath = first;
+    a.primPath.insert(a.primPath.end(), second.begin() + 1, second.end());
+    a.primW = w1 + w2;
+    return a;
+}
+
+#endif //EMBEDDEDROUTING_H
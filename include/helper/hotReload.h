@@ -0,0 +1,404 @@
+/**
+ * @file hotReload.h
+ * @brief Incremental reload of the csv files into immutable, shared network snapshots.
+ * @details A NetworkStore holds the current NetworkSnapshot behind a shared_ptr. A
+ * reload reads Locations.csv and Distances.csv, compares every row with the row loaded
+ * before (by location code, and by Location1,Location2 pair) and only parses and
+ * applies the rows that changed. The new snapshot shares everything else with the old
+ * one: vertices live in chunks of RELOAD_CHUNK slots and a chunk is copied only when
+ * one of its vertices changes (copy-on-write); the ID and code maps are shared unless
+ * locations were added or changed. The new snapshot is published with an atomic store,
+ * so queries that already hold the old one keep using it until they release it.
+ *
+ * The files are still read once per reload to find the changed rows, but parsing and
+ * updating the structure is proportional to the change (plus one pointer per chunk).
+ * Rows are parsed by parseLocationRow and parseDistanceRow (csvLoader.h), so a reload
+ * accepts and skips exactly the rows the other loaders do.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef HOTRELOAD_H
+#define HOTRELOAD_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <sys/stat.h>
+#include "../data_structs/Graph.h"
+#include "removers.h"
+#include "scc.h"
+#include "csvLoader.h"
+using namespace std;
+
+#define RELOAD_CHUNK 64
+
+/**
+ * @brief A location of a snapshot and its outgoing segments.
+ */
+struct SnapshotVertex {
+    int id = 0;
+    bool present = false;          ///< false once the location is removed (the slot is kept)
+    bool parking = false;
+    vector<pair<int, int>> drive;  ///< (target slot, driving time)
+    vector<pair<int, int>> walk;   ///< (target slot, walking time)
+};
+
+typedef vector<SnapshotVertex> VertexChunk;
+
+/**
+ * @brief Immutable version of the network.
+ */
+class NetworkSnapshot {
+public:
+    int getVersion() const;
+    int getNumSlots() const;
+    const SnapshotVertex &getVertex(int slot) const;
+    int findSlot(int id) const; // -1 if the ID was never loaded
+    const unordered_map<string, string> &getCodes() const;
+    /*
+     * Lines of the Locations.csv this version was loaded from, header first, so that the
+     * extra columns (names, coordinates) can be indexed without reading the file again.
+     */
+    const vector<string> &getLocationLines() const;
+
+    /*
+     * Fills empty graphs with the present locations and segments, in the same order as
+     * loadGraphs, and computes their component labels.
+     */
+    void fillGraphs(Graph<int> &drive, Graph<int> &walk) const;
+
+protected:
+    friend class NetworkStore;
+    int version = 0;
+    int numSlots = 0;
+    vector<shared_ptr<const VertexChunk>> chunks;
+    shared_ptr<const unordered_map<int, int>> slotOf = make_shared<unordered_map<int, int>>();
+    shared_ptr<const unordered_map<string, string>> codes = make_shared<unordered_map<string, string>>();
+    shared_ptr<const vector<string>> locationLines = make_shared<vector<string>>();
+};
+
+inline int NetworkSnapshot::getVersion() const {
+    return version;
+}
+
+inline int NetworkSnapshot::getNumSlots() const {
+    return numSlots;
+}
+
+inline const SnapshotVertex &NetworkSnapshot::getVertex(int slot) const {
+    return (*chunks[slot / RELOAD_CHUNK])[slot % RELOAD_CHUNK];
+}
+
+inline int NetworkSnapshot::findSlot(int id) const {
+    auto it = slotOf->find(id);
+    return it == slotOf->end() ? -1 : it->second;
+}
+
+inline const unordered_map<string, string> &NetworkSnapshot::getCodes() const {
+    return *codes;
+}
+
+inline const vector<string> &NetworkSnapshot::getLocationLines() const {
+    return *locationLines;
+}
+
+/**
+ * @brief Builds the graphs of a snapshot.
+ * @complexity O(V + E) plus the vertex lookups of Graph::addEdge.
+ */
+inline void NetworkSnapshot::fillGraphs(Graph<int> &drive, Graph<int> &walk) const {
+    MemoryScope scope(MEM_GRAPH);
+    for (int s = 0; s < numSlots; s++) {
+        const SnapshotVertex &v = getVertex(s);
+        if (!v.present) continue;
+        drive.addVertex(v.id);
+        walk.addVertex(v.id);
+        drive.findVertex(v.id)->setParking(v.parking);
+        walk.findVertex(v.id)->setParking(v.parking);
+    }
+    for (int s = 0; s < numSlots; s++) {
+        const SnapshotVertex &v = getVertex(s);
+        if (!v.present) continue;
+        for (auto &e : v.drive)
+            if (getVertex(e.first).present) drive.addEdge(v.id, getVertex(e.first).id, e.second);
+        for (auto &e : v.walk)
+            if (getVertex(e.first).present) walk.addEdge(v.id, getVertex(e.first).id, e.second);
+    }
+    computeComponents(&drive);
+    computeComponents(&walk);
+}
+
+/**
+ * @brief What a reload changed.
+ */
+struct ReloadStats {
+    int changedLocations = 0; ///< location rows added, removed or modified
+    int changedSegments = 0;  ///< Location1,Location2 pairs whose rows were re-applied
+    int copiedChunks = 0;     ///< vertex chunks copied for the new snapshot
+};
+
+/**
+ * @brief Owner of the current snapshot; reloads the csv files incrementally.
+ */
+class NetworkStore {
+public:
+    NetworkStore(const string &locationsFile = "data/Locations.csv",
+                 const string &distancesFile = "data/Distances.csv");
+
+    /*
+     * Current snapshot. Callers keep it alive for as long as they use it.
+     */
+    shared_ptr<const NetworkSnapshot> snapshot() const;
+
+    /*
+     * Diffs the files against the loaded rows and publishes a new snapshot if anything
+     * changed. Returns false if a file could not be read (the current snapshot is kept).
+     */
+    bool reload(ReloadStats *stats = nullptr);
+    /*
+     * Reloads only if the modification time or size of either file changed.
+     */
+    bool reloadIfChanged(ReloadStats *stats = nullptr);
+
+protected:
+    string locationsFile, distancesFile;
+    shared_ptr<const NetworkSnapshot> current; // only accessed with atomic_load/atomic_store
+    mutex reloadMutex;                        // one reload at a time
+
+    unordered_map<string, string> locationRows; // code -> row
+    unordered_map<string, string> segmentRows;  // "Location1,Location2" -> its rows, one per line
+    pair<long long, long long> locationsStamp{-1, -1}, distancesStamp{-1, -1};
+};
+
+inline NetworkStore::NetworkStore(const string &locationsFile, const string &distancesFile)
+        : locationsFile(locationsFile), distancesFile(distancesFile), current(make_shared<NetworkSnapshot>()) {
+    reload();
+}
+
+inline shared_ptr<const NetworkSnapshot> NetworkStore::snapshot() const {
+    return atomic_load(&current);
+}
+
+/**
+ * @brief Modification time and size of a file, or (-1, -1) if it does not exist.
+ */
+inline pair<long long, long long> fileStamp(const string &path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return {-1, -1};
+    return {(long long) st.st_mtime, (long long) st.st_size};
+}
+
+inline bool NetworkStore::reloadIfChanged(ReloadStats *stats) {
+    {
+        lock_guard<mutex> lock(reloadMutex);
+        if (fileStamp(locationsFile) == locationsStamp && fileStamp(distancesFile) == distancesStamp)
+            return true;
+    }
+    return reload(stats);
+}
+
+/**
+ * @brief Reloads the csv files, applying only the rows that changed.
+ * @details A segment is re-applied when its rows changed or when the code of either
+ * end changed; its old edges are removed with the old codes and the new ones added
+ * with the new codes. Removed locations keep their slot, marked as not present.
+ * @complexity O(N) string comparisons for N rows, plus O(C d + V / RELOAD_CHUNK)
+ * to apply C changed rows.
+ */
+inline bool NetworkStore::reload(ReloadStats *stats) {
+    MemoryScope scope(MEM_LOADER);
+    lock_guard<mutex> lock(reloadMutex);
+    pair<long long, long long> locStamp = fileStamp(locationsFile), distStamp = fileStamp(distancesFile);
+    ifstream locFile(locationsFile), distFile(distancesFile);
+    if (!locFile.is_open() || !distFile.is_open()) {
+        cerr << "Error opening file: " << (locFile.is_open() ? distancesFile : locationsFile) << endl;
+        return false;
+    }
+
+    // read both files as raw rows, keyed like the loaded ones
+    unordered_map<string, string> newLocations, newSegments;
+    vector<string> locationOrder, segmentOrder; // keys in file order, so that slots and edges follow the files
+    auto locationLines = make_shared<vector<string>>();
+    string line;
+    while (getline(locFile, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        locationLines->push_back(line);
+        if (locationLines->size() == 1) continue; // header
+        size_t c1 = line.find(','), c2 = c1 == string::npos ? c1 : line.find(',', c1 + 1);
+        if (c2 == string::npos) continue;
+        size_t c3 = line.find(',', c2 + 1);
+        string code = line.substr(c2 + 1, c3 == string::npos ? string::npos : c3 - c2 - 1);
+        if (!newLocations.count(code)) locationOrder.push_back(code);
+        newLocations[code] = line;
+    }
+    getline(distFile, line); // skip header
+    while (getline(distFile, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        size_t c1 = line.find(','), c2 = c1 == string::npos ? c1 : line.find(',', c1 + 1);
+        if (c2 == string::npos) continue;
+        string key = line.substr(0, c2);
+        auto ins = newSegments.insert({key, string()});
+        if (ins.second) segmentOrder.push_back(key);
+        string &rows = ins.first->second;
+        if (!rows.empty()) rows += '\n'; // repeated pairs keep all of their rows
+        rows += line;
+    }
+
+    ReloadStats st;
+    unordered_set<string> changedCodes;
+    for (auto &l : newLocations) {
+        auto it = locationRows.find(l.first);
+        if (it == locationRows.end() || it->second != l.second) changedCodes.insert(l.first);
+    }
+    for (auto &l : locationRows)
+        if (!newLocations.count(l.first)) changedCodes.insert(l.first);
+
+    vector<string> changedSegments;
+    for (const string &key : segmentOrder) {
+        size_t comma = key.find(',');
+        auto it = segmentRows.find(key);
+        if (it == segmentRows.end() || it->second != newSegments[key] ||
+            changedCodes.count(key.substr(0, comma)) || changedCodes.count(key.substr(comma + 1)))
+            changedSegments.push_back(key);
+    }
+    for (auto &s : segmentRows)
+        if (!newSegments.count(s.first)) changedSegments.push_back(s.first);
+
+    shared_ptr<const NetworkSnapshot> old = atomic_load(&current);
+    locationsStamp = locStamp;
+    distancesStamp = distStamp;
+    if (changedCodes.empty() && changedSegments.empty()) {
+        if (stats != nullptr) *stats = st;
+        return true;
+    }
+
+    auto next = make_shared<NetworkSnapshot>(*old); // shares every chunk and map
+    next->version = old->version + 1;
+    vector<char> copied(next->chunks.size(), 0);
+    auto vertexAt = [&](int slot) -> SnapshotVertex & {
+        size_t c = slot / RELOAD_CHUNK;
+        if (c >= copied.size()) copied.resize(c + 1, 0);
+        if (!copied[c]) {
+            next->chunks[c] = make_shared<VertexChunk>(*next->chunks[c]);
+            copied[c] = 1;
+            st.copiedChunks++;
+        }
+        return const_cast<VertexChunk &>(*next->chunks[c])[slot % RELOAD_CHUNK];
+    };
+    auto idOf = [](const unordered_map<string, string> &codes, const string &code, int &id) {
+        auto it = codes.find(code);
+        if (it == codes.end()) return false;
+        const char *p = it->second.data(), *end = p + it->second.size();
+        return parseInt(p, end, id) && p == end;
+    };
+
+    // locations
+    if (!changedCodes.empty()) {
+        auto codes = make_shared<unordered_map<string, string>>(*old->codes);
+        auto slotOf = make_shared<unordered_map<int, int>>(*old->slotOf);
+        unordered_set<int> stillUsed;
+        for (auto &l : newLocations) {
+            int id; // rows skipped as invalid have no code in codes
+            if (!changedCodes.count(l.first) && idOf(*codes, l.first, id)) stillUsed.insert(id);
+        }
+
+        for (const string &code : changedCodes) {
+            int oldId;
+            if (idOf(*codes, code, oldId) && !stillUsed.count(oldId)) {
+                SnapshotVertex &v = vertexAt(slotOf->at(oldId));
+                v.present = false;
+                v.drive.clear();
+                v.walk.clear();
+            }
+            codes->erase(code);
+        }
+        for (const string &code : locationOrder) {
+            if (!changedCodes.count(code)) continue;
+            string rowCode;
+            int id;
+            bool parking;
+            if (!parseLocationRow(newLocations[code], rowCode, id, parking)) { // same rules as loadLocations
+                cerr << "Warning: skipping invalid location " << code << " in " << locationsFile << endl;
+                continue;
+            }
+            auto s = slotOf->find(id);
+            int slot;
+            if (s != slotOf->end()) slot = s->second;
+            else {
+                slot = next->numSlots++;
+                (*slotOf)[id] = slot;
+                if (slot % RELOAD_CHUNK == 0) {
+                    next->chunks.push_back(make_shared<VertexChunk>(RELOAD_CHUNK));
+                    copied.push_back(1);
+                }
+            }
+            SnapshotVertex &v = vertexAt(slot);
+            v.id = id;
+            v.parking = parking;
+            v.present = true;
+            (*codes)[code] = to_string(id);
+            stillUsed.insert(id);
+        }
+        next->codes = codes;
+        next->slotOf = slotOf;
+        next->locationLines = locationLines;
+    }
+
+    // segments: remove the old edges of every changed or vanished pair, then add the new
+    // ones. Two passes, because an old pair and a new one may join the same two slots
+    // (a location whose code changed), and removing by slot would drop the new edges too.
+    for (const string &key : changedSegments) {
+        size_t comma = key.find(',');
+        int u, v;
+        if (segmentRows.count(key) && idOf(*old->codes, key.substr(0, comma), u) &&
+            idOf(*old->codes, key.substr(comma + 1), v)) {
+            int us = old->findSlot(u), vs = old->findSlot(v);
+            SnapshotVertex &x = vertexAt(us);
+            auto toV = [vs](const pair<int, int> &e) { return e.first == vs; };
+            x.drive.erase(remove_if(x.drive.begin(), x.drive.end(), toV), x.drive.end());
+            x.walk.erase(remove_if(x.walk.begin(), x.walk.end(), toV), x.walk.end());
+        }
+    }
+    for (const string &key : changedSegments) {
+        size_t comma = key.find(',');
+        string src = key.substr(0, comma), dest = key.substr(comma + 1);
+        int u, v;
+        auto it = newSegments.find(key);
+        if (it == newSegments.end()) continue;
+        if (!idOf(*next->codes, src, u) || !idOf(*next->codes, dest, v)) {
+            cerr << "Warning: skipping segment with unknown location " << key << " in " << distancesFile << endl;
+            continue;
+        }
+        int us = next->findSlot(u), vs = next->findSlot(v);
+        SnapshotVertex &x = vertexAt(us);
+        stringstream rows(it->second); // the rows of the pair, one per line
+        string row, rowSrc, rowDest;
+        while (getline(rows, row)) {
+            int driving, walking;
+            if (!parseDistanceRow(row, rowSrc, rowDest, driving, walking)) { // same rules as loadDistances
+                cerr << "Warning: skipping invalid segment " << key << " in " << distancesFile << endl;
+                continue;
+            }
+            if (driving >= 0) x.drive.push_back({vs, driving});
+            if (walking >= 0) x.walk.push_back({vs, walking});
+        }
+    }
+
+    st.changedLocations = changedCodes.size();
+    st.changedSegments = changedSegments.size();
+    locationRows.swap(newLocations);
+    segmentRows.swap(newSegments);
+    atomic_store(&current, shared_ptr<const NetworkSnapshot>(next));
+    if (stats != nullptr) *stats = st;
+    return true;
+}
+
+#endif //HOTRELOAD_H
@@ -0,0 +1,336 @@
+/**
+ * @file hubLabels.h
+ * @brief Hub labeling (2-hop) distance oracle.
+ * @details Every vertex v gets an out-label (hubs it can reach, with distances) and an
+ * in-label (hubs that reach it). The distance from s to t is the minimum of
+ * out(s)[h] + in(t)[h] over the hubs h common to both labels, so a query is a merge of
+ * two sorted arrays and needs no search at all. Answers are exact: they match dijkstra.
+ *
+ * The labels are built with pruned landmark labeling (PLL): vertices are processed in a
+ * configurable order (by default, by decreasing degree) and each one runs a forward and a
+ * backward Dijkstra that stops wherever the labels built so far already give the distance.
+ *
+ * Labels are stored in flat arrays sorted by hub rank and can be saved to a binary file
+ * that is memory-mapped at startup, so loading does not parse or copy anything.
+ *
+ * File layout (all little-endian uint32): magic "HLB1", version, V, out entries,
+ * in entries; then slot -> vertex ID [V], out offsets [V+1], out hubs, out distances,
+ * in offsets [V+1], in hubs, in distances.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef HUBLABELS_H
+#define HUBLABELS_H
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../data_structs/CSRGraph.h"
+#include "csrDijkstra.h"
+using namespace std;
+
+#define HUB_LABELS_MAGIC 0x31424c48u // "HLB1"
+#define HUB_LABELS_VERSION 1u
+#define HUB_NO_DIST 0xffffffffu
+
+/**
+ * @brief Exact distance oracle based on 2-hop labels.
+ */
+class HubLabels {
+public:
+    HubLabels() {}
+    ~HubLabels();
+    HubLabels(const HubLabels &) = delete;
+    HubLabels &operator=(const HubLabels &) = delete;
+
+    /*
+     * Builds the labels of g. order lists the slots from most to least important;
+     * an empty order sorts them by decreasing degree.
+     */
+    void build(const CSRGraph<int> &g, const vector<int> &order = vector<int>());
+
+    /*
+     * Saves the labels to a binary file. Returns false on failure.
+     */
+    bool save(const string &path) const;
+    /*
+     * Memory-maps a file written by save. Returns false if it is missing or invalid.
+     */
+    bool load(const string &path);
+
+    /*
+     * Distance between two vertex IDs; INT_INF if unreachable or unknown.
+     */
+    int distance(int source, int dest) const;
+    int distanceSlots(int s, int t) const;
+
+    int getNumVertex() const;
+    size_t getNumEntries() const; // total label entries (in + out)
+
+private:
+    uint32_t n = 0, outCount = 0, inCount = 0;
+    const uint32_t *ids = nullptr, *outOff = nullptr, *outHub = nullptr, *outDist = nullptr;
+    const uint32_t *inOff = nullptr, *inHub = nullptr, *inDist = nullptr;
+    vector<uint32_t> owned;      // backing storage after build
+    void *mapping = nullptr;     // backing storage after load
+    size_t mappingSize = 0;
+    unordered_map<int, int> slotOf;
+
+    void release();
+    void attach(const uint32_t *base);
+    static bool validOffsets(const uint32_t *off, uint32_t n, uint32_t count);
+};
+
+inline HubLabels::~HubLabels() {
+    release();
+}
+
+inline void HubLabels::release() {
+    if (mapping != nullptr) munmap(mapping, mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+    owned.clear();
+    slotOf.clear();
+    n = outCount = inCount = 0;
+}
+
+/**
+ * @brief Points the query arrays into a buffer with the file layout.
+ * @complexity O(V), to rebuild the vertex ID map.
+ */
+inline void HubLabels::attach(const uint32_t *base) {
+    n = base[2];
+    outCount = base[3];
+    inCount = base[4];
+    const uint32_t *p = base + 5;
+    ids = p;      p += n;
+    outOff = p;   p += n + 1;
+    outHub = p;   p += outCount;
+    outDist = p;  p += outCount;
+    inOff = p;    p += n + 1;
+    inHub = p;    p += inCount;
+    inDist = p;
+    slotOf.clear();
+    for (uint32_t i = 0; i < n; i++) slotOf[(int) ids[i]] = i;
+}
+
+/**
+ * @brief Checks that label offsets start at 0, never decrease and end at count, so
+ * that every label lies within its hub and distance arrays.
+ * @complexity O(V).
+ */
+inline bool HubLabels::validOffsets(const uint32_t *off, uint32_t n, uint32_t count) {
+    if (off[0] != 0 || off[n] != count) return false;
+    for (uint32_t i = 0; i < n; i++)
+        if (off[i] > off[i + 1]) return false;
+    return true;
+}
+
+inline int HubLabels::getNumVertex() const {
+    return n;
+}
+
+inline size_t HubLabels::getNumEntries() const {
+    return (size_t) outCount + inCount;
+}
+
+/**
+ * @brief Merge-intersects out(s) and in(t).
+ * @complexity O(|out(s)| + |in(t)|).
+ */
+inline int HubLabels::distanceSlots(int s, int t) const {
+    if (s < 0 || t < 0 || (uint32_t) s >= n || (uint32_t) t >= n) return INT_INF;
+    uint32_t i = outOff[s], ie = outOff[s + 1];
+    uint32_t j = inOff[t], je = inOff[t + 1];
+    uint64_t best = HUB_NO_DIST;
+    while (i < ie && j < je) {
+        uint32_t a = outHub[i], b = inHub[j];
+        if (a == b) {
+            uint64_t d = (uint64_t) outDist[i++] + inDist[j++];
+            if (d < best) best = d;
+        } else if (a < b) {
+            i++;
+        } else {
+            j++;
+        }
+    }
+    return best >= (uint64_t) INT_INF ? INT_INF : (int) best;
+}
+
+inline int HubLabels::distance(int source, int dest) const {
+    auto a = slotOf.find(source), b = slotOf.find(dest);
+    if (a == slotOf.end() || b == slotOf.end()) return INT_INF;
+    return distanceSlots(a->second, b->second);
+}
+
+/**
+ * @brief Builds the labels with pruned landmark labeling.
+ * @details For the k-th vertex v of the order, a forward pruned Dijkstra adds (k, d) to
+ * the in-label of every vertex u it reaches at distance d, unless the current labels
+ * already give dist(v, u) <= d (then u is not expanded either). A backward search on
+ * the reversed graph does the same for out-labels. Hubs are added in rank order, so
+ * every label is sorted by hub rank.
+ * @complexity O(V (L log V + E)) in practice, for labels of average size L.
+ */
+inline void HubLabels::build(const CSRGraph<int> &g, const vector<int> &order) {
+    release();
+    int N = g.getNumVertex();
+    vector<int> ord = order;
+    if ((int) ord.size() != N) {
+        CSRGraph<int> r = g.reversed();
+        ord.resize(N);
+        for (int i = 0; i < N; i++) ord[i] = i;
+        stable_sort(ord.begin(), ord.end(), [&](int a, int b) {
+            int da = g.edgeEnd(a) - g.edgeBegin(a) + r.edgeEnd(a) - r.edgeBegin(a);
+            int db = g.edgeEnd(b) - g.edgeBegin(b) + r.edgeEnd(b) - r.edgeBegin(b);
+            return da > db;
+        });
+    }
+    CSRGraph<int> rev = g.reversed();
+
+    vector<vector<pair<uint32_t, uint32_t>>> outL(N), inL(N); // (hub rank, distance)
+    vector<uint32_t> tmp(N, HUB_NO_DIST);  // dense copy of the current root's label, by rank
+    vector<int> dist(N, INT_INF);
+    vector<int> touched;
+    typedef pair<int, int> Entry;
+
+    for (int k = 0; k < N; k++) {
+        int v = ord[k];
+        for (int dir = 0; dir < 2; dir++) {
+            // dir 0: forward from v, fills in-labels; dir 1: backward to v, fills out-labels
+            const CSRGraph<int> &G = dir == 0 ? g : rev;
+            auto &rootL = dir == 0 ? outL[v] : inL[v];
+            auto &fill = dir == 0 ? inL : outL;
+            for (auto &h : rootL) tmp[h.first] = h.second;
+            tmp[k] = 0;
+
+            priority_queue<Entry, vector<Entry>, greater<Entry>> q;
+            dist[v] = 0;
+            touched.push_back(v);
+            q.push({0, v});
+            while (!q.empty()) {
+                Entry top = q.top();
+                q.pop();
+                int u = top.second, d = top.first;
+                if (d > dist[u]) continue;
+                bool pruned = false;
+                for (auto &h : fill[u]) {
+                    if (tmp[h.first] != HUB_NO_DIST && (uint64_t) tmp[h.first] + h.second <= (uint64_t) d) {
+                        pruned = true;
+                        break;
+                    }
+                }
+                if (pruned) continue;
+                fill[u].push_back({(uint32_t) k, (uint32_t) d});
+                for (int e = G.edgeBegin(u); e < G.edgeEnd(u); e++) {
+                    int w = G.getTarget(e), nd = d + G.getWeight(e);
+                    if (nd < dist[w]) {
+                        if (dist[w] == INT_INF) touched.push_back(w);
+                        dist[w] = nd;
+                        q.push({nd, w});
+                    }
+                }
+            }
+            for (int u : touched) dist[u] = INT_INF;
+            touched.clear();
+            for (auto &h : rootL) tmp[h.first] = HUB_NO_DIST;
+            tmp[k] = HUB_NO_DIST;
+        }
+    }
+
+    size_t outTotal = 0, inTotal = 0;
+    for (int i = 0; i < N; i++) {
+        outTotal += outL[i].size();
+        inTotal += inL[i].size();
+    }
+    owned.assign(5 + N + 2 * (N + 1) + 2 * outTotal + 2 * inTotal, 0);
+    uint32_t *p = owned.data();
+    p[0] = HUB_LABELS_MAGIC;
+    p[1] = HUB_LABELS_VERSION;
+    p[2] = N;
+    p[3] = outTotal;
+    p[4] = inTotal;
+    uint32_t *pIds = p + 5, *pOutOff = pIds + N, *pOutHub = pOutOff + N + 1, *pOutDist = pOutHub + outTotal;
+    uint32_t *pInOff = pOutDist + outTotal, *pInHub = pInOff + N + 1, *pInDist = pInHub + inTotal;
+    for (int i = 0; i < N; i++) pIds[i] = g.getInfo(i);
+    uint32_t o = 0, in = 0;
+    for (int i = 0; i < N; i++) {
+        pOutOff[i] = o;
+        for (auto &h : outL[i]) { pOutHub[o] = h.first; pOutDist[o++] = h.second; }
+        pInOff[i] = in;
+        for (auto &h : inL[i]) { pInHub[in] = h.first; pInDist[in++] = h.second; }
+    }
+    pOutOff[N] = o;
+    pInOff[N] = in;
+    attach(owned.data());
+}
+
+/**
+ * @brief Writes the labels to a binary file.
+ * @complexity O(V + L).
+ */
+inline bool HubLabels::save(const string &path) const {
+    if (ids == nullptr) return false;
+    FILE *f = fopen(path.c_str(), "wb");
+    if (f == nullptr) return false;
+    uint32_t header[5] = {HUB_LABELS_MAGIC, HUB_LABELS_VERSION, n, outCount, inCount};
+    bool ok = fwrite(header, sizeof(uint32_t), 5, f) == 5;
+    ok = ok && fwrite(ids, sizeof(uint32_t), n, f) == n;
+    ok = ok && fwrite(outOff, sizeof(uint32_t), n + 1, f) == n + 1;
+    ok = ok && fwrite(outHub, sizeof(uint32_t), outCount, f) == outCount;
+    ok = ok && fwrite(outDist, sizeof(uint32_t), outCount, f) == outCount;
+    ok = ok && fwrite(inOff, sizeof(uint32_t), n + 1, f) == n + 1;
+    ok = ok && fwrite(inHub, sizeof(uint32_t), inCount, f) == inCount;
+    ok = ok && fwrite(inDist, sizeof(uint32_t), inCount, f) == inCount;
+    return fclose(f) == 0 && ok;
+}
+
+/**
+ * @brief Memory-maps a label file.
+ * @details The header and the array sizes are checked against the file size, and the
+ * label offsets against the array sizes, before use.
+ * @complexity O(V), to rebuild the vertex ID map; the labels are paged in on demand.
+ */
+inline bool HubLabels::load(const string &path) {
+    release();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t) (5 * sizeof(uint32_t))) {
+        close(fd);
+        return false;
+    }
+    void *m = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (m == MAP_FAILED) return false;
+
+    const uint32_t *h = (const uint32_t *) m;
+    uint64_t expected = 5 + (uint64_t) h[2] + 2 * ((uint64_t) h[2] + 1) + 2 * (uint64_t) h[3] + 2 * (uint64_t) h[4];
+    bool ok = h[0] == HUB_LABELS_MAGIC && h[1] == HUB_LABELS_VERSION && expected * sizeof(uint32_t) == (uint64_t) st.st_size;
+    if (ok) {
+        const uint32_t *outOffsets = h + 5 + h[2], *inOffsets = outOffsets + h[2] + 1 + 2 * (uint64_t) h[3];
+        ok = validOffsets(outOffsets, h[2], h[3]) && validOffsets(inOffsets, h[2], h[4]);
+    }
+    if (!ok) {
+        munmap(m, st.st_size);
+        return false;
+    }
+    mapping = m;
+    mappingSize = st.st_size;
+    attach(h);
+    return true;
+}
+
+#endif //HUBLABELS_H
@@ -0,0 +1,234 @@
+/**
+ * @file isochrone.h
+ * @brief Bounded-radius reachability queries (isochrones).
+ * @details Answers "which locations can be reached from X within a travel budget",
+ * by driving only or by driving to a parking node and walking from there.
+ * The search stops expanding as soon as the budget is exceeded and keeps its
+ * state in local containers, so only the vertices inside the budget are touched
+ * and the graph itself is never modified.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef ISOCHRONE_H
+#define ISOCHRONE_H
+
+#include <vector>
+#include <set>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include "../data_structs/Graph.h"
+using namespace std;
+
+/**
+ * @brief Result of an isochrone query.
+ */
+template <class T>
+struct IsochroneResult {
+    T origin;                            ///< origin of the query
+    vector<pair<T, double>> reachable;   ///< reachable vertex IDs and their cost, by non-decreasing cost
+    vector<Edge<T> *> frontier;          ///< edges leaving the reachable set (only filled on request)
+};
+
+/**
+ * @brief Bounded multi-source search shared by all isochrone queries.
+ * @details Runs Dijkstra from the given seeds, never pushing a vertex whose cost
+ * exceeds the budget. Restricted vertices and segments are skipped instead of
+ * being removed from the graph.
+ *
+ * @tparam T Type of the graph vertices.
+ * @param seeds Starting vertices with their initial cost.
+ * @param budget Maximum cost allowed.
+ * @param avoidNodes Vertices that cannot be used.
+ * @param avoidSegments Segments (origin, destination) that cannot be used.
+ * @param dist Receives the final cost of every settled vertex.
+ * @param order Receives the settled vertices by non-decreasing cost.
+ * @complexity O((V' + E') log V'), where V' and E' are the vertices and edges inside the budget.
+ */
+template <class T>
+void boundedSearch(const vector<pair<Vertex<T> *, double>> & seeds, double budget,
+                   const unordered_set<T> & avoidNodes, const set<pair<T, T>> & avoidSegments,
+                   unordered_map<Vertex<T> *, double> & dist, vector<Vertex<T> *> & order) {
+    typedef pair<double, Vertex<T> *> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> q;
+    unordered_map<Vertex<T> *, double> tentative;
+
+    for (auto & s : seeds) {
+        if (s.first == nullptr || s.second > budget || avoidNodes.count(s.first->getInfo())) continue;
+        auto it = tentative.find(s.first);
+        if (it == tentative.end() || s.second < it->second) {
+            tentative[s.first] = s.second;
+            q.push({s.second, s.first});
+        }
+    }
+
+    while (!q.empty()) {
+        Entry top = q.top();
+        q.pop();
+        Vertex<T> *u = top.second;
+        if (dist.count(u) || top.first > tentative[u]) continue; // stale entry
+        dist[u] = top.first;
+        order.push_back(u);
+
+        for (auto e : u->getAdj()) {
+            Vertex<T> *v = e->getDest();
+            if (dist.count(v) || avoidNodes.count(v->getInfo())) continue;
+            if (!avoidSegments.empty() && avoidSegments.count({u->getInfo(), v->getInfo()})) continue;
+            double nd = top.first + e->getWeight();
+            if (nd > budget) continue;
+            auto it = tentative.find(v);
+            if (it == tentative.end() || nd < it->second) {
+                tentative[v] = nd;
+                q.push({nd, v});
+            }
+        }
+    }
+}
+
+/**
+ * @brief Collects the edges that leave the settled set.
+ * @details An edge is part of the frontier when its origin is reachable within the
+ * budget, it is not restricted, and its destination is not reachable.
+ *
+ * @complexity O(E'), where E' is the number of edges leaving the settled vertices.
+ */
+template <class T>
+vector<Edge<T> *> frontierEdges(const vector<Vertex<T> *> & order, const unordered_map<Vertex<T> *, double> & dist,
+                                const unordered_set<T> & avoidNodes, const set<pair<T, T>> & avoidSegments) {
+    vector<Edge<T> *> frontier;
+    for (auto u : order) {
+        for (auto e : u->getAdj()) {
+            Vertex<T> *v = e->getDest();
+            if (dist.count(v) || avoidNodes.count(v->getInfo())) continue;
+            if (!avoidSegments.empty() && avoidSegments.count({u->getInfo(), v->getInfo()})) continue;
+            frontier.push_back(e);
+        }
+    }
+    return frontier;
+}
+
+/**
+ * @brief Computes every location reachable from an origin within a budget.
+ * @details The restrictions use the same format produced by parseAvoidNodes and
+ * parseAvoidSegments in removers.h.
+ *
+ * @tparam T Type of the graph vertices.
+ * @param g Graph to search (e.g. the driving graph).
+ * @param origin Source vertex ID.
+ * @param budget Maximum travel cost.
+ * @param avoidNodes Vertex IDs that cannot be used.
+ * @param avoidSegments Segments (origin, destination) that cannot be used.
+ * @param withFrontier Whether the frontier edges should also be returned.
+ * @return IsochroneResult with the reachable vertices (empty if the origin does not exist).
+ * @complexity O((V' + E') log V'), where V' and E' are the vertices and edges inside the budget.
+ */
+template <class T>
+IsochroneResult<T> isochrone(Graph<T> & g, const T & origin, double budget,
+                             const vector<T> & avoidNodes = vector<T>(),
+                             const vector<pair<T, T>> & avoidSegments = vector<pair<T, T>>(),
+                             bool withFrontier = false) {
+    IsochroneResult<T> res;
+    res.origin = origin;
+    unordered_set<T> nodes(avoidNodes.begin(), avoidNodes.end());
+    set<pair<T, T>> segments(avoidSegments.begin(), avoidSegments.end());
+
+    unordered_map<Vertex<T> *, double> dist;
+    vector<Vertex<T> *> order;
+    boundedSearch<T>({{g.findVertex(origin), 0.0}}, budget, nodes, segments, dist, order);
+
+    for (auto v : order) {
+        res.reachable.push_back({v->getInfo(), dist[v]});
+    }
+    if (withFrontier) {
+        res.frontier = frontierEdges(order, dist, nodes, segments);
+    }
+    return res;
+}
+
+/**
+ * @brief Batch form of isochrone, one result per origin.
+ * @details Each origin runs its own bounded search with the same restrictions.
+ *
+ * @complexity O(K (V' + E') log V'), for K origins.
+ */
+template <class T>
+vector<IsochroneResult<T>> isochrones(Graph<T> & g, const vector<T> & origins, double budget,
+                                      const vector<T> & avoidNodes = vector<T>(),
+                                      const vector<pair<T, T>> & avoidSegments = vector<pair<T, T>>(),
+                                      bool withFrontier = false) {
+    vector<IsochroneResult<T>> res;
+    res.reserve(origins.size());
+    for (auto & o : origins) {
+        res.push_back(isochrone(g, o, budget, avoidNodes, avoidSegments, withFrontier));
+    }
+    return res;
+}
+
+/**
+ * @brief Computes every location reachable by driving and/or walking within a budget.
+ * @details First runs a bounded search on the driving graph. Every parking node reached
+ * by car, plus the origin itself, then seeds a bounded search on the walking graph with
+ * the budget that is left. A location is reachable if it can be reached by car or on foot,
+ * with the cheapest of both costs. Frontier edges belong to the walking graph.
+ *
+ * @tparam T Type of the graph vertices.
+ * @param drive Graph containing the driving distances.
+ * @param walk Graph containing the walking distances.
+ * @param origin Source vertex ID.
+ * @param budget Maximum total travel cost (driving + walking).
+ * @param avoidNodes Vertex IDs that cannot be used in either mode.
+ * @param avoidSegments Segments that cannot be used in either mode.
+ * @param withFrontier Whether the frontier edges should also be returned.
+ * @return IsochroneResult with the reachable vertices.
+ * @complexity O((V' + E') log V') over both graphs.
+ */
+template <class T>
+IsochroneResult<T> driveWalkIsochrone(Graph<T> & drive, Graph<T> & walk, const T & origin, double budget,
+                                      const vector<T> & avoidNodes = vector<T>(),
+                                      const vector<pair<T, T>> & avoidSegments = vector<pair<T, T>>(),
+                                      bool withFrontier = false) {
+    IsochroneResult<T> res;
+    res.origin = origin;
+    unordered_set<T> nodes(avoidNodes.begin(), avoidNodes.end());
+    set<pair<T, T>> segments(avoidSegments.begin(), avoidSegments.end());
+
+    unordered_map<Vertex<T> *, double> driveDist;
+    vector<Vertex<T> *> driveOrder;
+    boundedSearch<T>({{drive.findVertex(origin), 0.0}}, budget, nodes, segments, driveDist, driveOrder);
+
+    // Park the car at any parking node reached by driving (or leave it at home) and walk.
+    vector<pair<Vertex<T> *, double>> seeds;
+    seeds.push_back({walk.findVertex(origin), 0.0});
+    for (auto v : driveOrder) {
+        if (v->hasParking()) {
+            seeds.push_back({walk.findVertex(v->getInfo()), driveDist[v]});
+        }
+    }
+    unordered_map<Vertex<T> *, double> walkDist;
+    vector<Vertex<T> *> walkOrder;
+    boundedSearch<T>(seeds, budget, nodes, segments, walkDist, walkOrder);
+
+    unordered_map<T, double> best;
+    for (auto v : driveOrder) best[v->getInfo()] = driveDist[v];
+    for (auto v : walkOrder) {
+        auto it = best.find(v->getInfo());
+        if (it == best.end() || walkDist[v] < it->second) best[v->getInfo()] = walkDist[v];
+    }
+    for (auto & p : best) {
+        res.reachable.push_back({p.first, p.second});
+    }
+    sort(res.reachable.begin(), res.reachable.end(),
+         [](const pair<T, double> & a, const pair<T, double> & b) {
+             return a.second < b.second || (a.second == b.second && a.first < b.first);
+         });
+    if (withFrontier) {
+        res.frontier = frontierEdges(walkOrder, walkDist, nodes, segments);
+    }
+    return res;
+}
+
+#endif //ISOCHRONE_H
@@ -0,0 +1,374 @@
+/**
+ * @file locationResolver.h
+ * @brief Finds locations by ID, code, name prefix or coordinates.
+ * @details loadLocations only keeps a code -> ID map for loadDistances. The resolver
+ * keeps an index of Locations.csv for the lifetime of the program, so that queries can
+ * name their locations instead of giving numeric IDs:
+ *
+ * - IDs and codes are looked up in hash maps, in O(1).
+ * - Names are folded to lower case (ASCII and the Latin-1 letters of UTF-8, so
+ *   "campanhã" finds "SRA.CAMPANHÃ") and sorted; a name prefix is found with a binary
+ *   search, in O(log V + matches).
+ * - If the file has Latitude and Longitude columns, the locations are bucketed in a
+ *   uniform grid of about one location per cell, and a point is snapped to the
+ *   nearest location by searching rings of cells outwards.
+ *
+ * resolve accepts any of these forms: a numeric ID, a code, a name or unique name
+ * prefix, or "@latitude,longitude".
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef LOCATIONRESOLVER_H
+#define LOCATIONRESOLVER_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <unordered_map>
+#include "memoryStats.h"
+#include "csvLoader.h"
+using namespace std;
+
+/**
+ * @brief One row of Locations.csv.
+ */
+struct LocationEntry {
+    int id = 0;
+    string name;
+    string code;
+    bool parking = false;
+    bool hasCoords = false;
+    double lat = 0, lon = 0;
+};
+
+/**
+ * @brief Folds a name for case-insensitive comparison.
+ * @details Lowers ASCII letters, replaces the two-byte UTF-8 Latin-1 letters (U+00C0 to
+ * U+00FF) by their unaccented lowercase ASCII letter, so "Campanha" finds "CAMPANHÃ",
+ * and trims surrounding spaces.
+ * @complexity O(L).
+ */
+inline string foldName(const string &s) {
+    static const char latin1[] = "aaaaaaaceeeeiiiidnooooo*ouuuuyts" "aaaaaaaceeeeiiiidnooooo/ouuuuyty";
+    string out;
+    out.reserve(s.size());
+    size_t b = s.find_first_not_of(" \t\r\n"), e = s.find_last_not_of(" \t\r\n");
+    if (b == string::npos) return out;
+    for (size_t i = b; i <= e; i++) {
+        unsigned char c = s[i];
+        if (c >= 'A' && c <= 'Z') out += (char) (c - 'A' + 'a');
+        else if (c == 0xC3 && i + 1 <= e && (unsigned char) s[i + 1] >= 0x80 && (unsigned char) s[i + 1] <= 0xBF) {
+            out += latin1[(unsigned char) s[++i] - 0x80];
+        }
+        else out += (char) c;
+    }
+    return out;
+}
+
+/**
+ * @brief Index of the locations for lookups by ID, code, name prefix and coordinates.
+ */
+class LocationResolver {
+public:
+    /**
+     * @brief Loads a Locations.csv file and builds the indexes.
+     * @return False if the file could not be read.
+     * @complexity O(V log V).
+     */
+    bool load(const string &path);
+
+    /**
+     * @brief Builds the indexes from the lines of a Locations.csv file, header first
+     * (see NetworkSnapshot::getLocationLines).
+     * @details Rows are parsed by parseLocationRow (csvLoader.h), so the resolver knows
+     * exactly the locations the loaders keep. Only the name (first column) and the
+     * optional Latitude/Lat and Longitude/Lon/Lng columns, found by header name, are
+     * read here.
+     * @complexity O(V log V).
+     */
+    void load(const vector<string> &lines);
+
+    /**
+     * @brief Adds a location; call build() once all are added.
+     */
+    void add(const LocationEntry &e) {
+        entries.push_back(e);
+    }
+
+    /**
+     * @brief Builds the code, name and grid indexes.
+     * @complexity O(V log V).
+     */
+    void build();
+
+    int size() const {
+        return entries.size();
+    }
+
+    /**
+     * @brief Location with the given ID, or nullptr.
+     */
+    const LocationEntry *findId(int id) const {
+        auto it = byId.find(id);
+        return it == byId.end() ? nullptr : &entries[it->second];
+    }
+
+    /**
+     * @brief Location with the given code (exact match), or nullptr.
+     */
+    const LocationEntry *findCode(const string &code) const {
+        auto it = byCode.find(code);
+        return it == byCode.end() ? nullptr : &entries[it->second];
+    }
+
+    /**
+     * @brief Locations whose name starts with a prefix, ignoring case, in name order.
+     * @param prefix Name prefix.
+     * @param limit Maximum number of results.
+     * @complexity O(log V + limit).
+     */
+    vector<const LocationEntry *> findPrefix(const string &prefix, size_t limit = 10) const;
+
+    /**
+     * @brief Location nearest to a point, or nullptr if no location has coordinates.
+     * @complexity O(1) expected for evenly spread locations.
+     */
+    const LocationEntry *nearest(double lat, double lon) const;
+
+    /**
+     * @brief Resolves a location given as an ID, code, name, unique name prefix or "@lat,lon".
+     * @param token Text of the location.
+     * @param id Receives the location ID.
+     * @param err Receives a description of the problem on failure.
+     * @return True if the token names exactly one location.
+     */
+    bool resolve(const string &token, int &id, string &err) const;
+
+private:
+    vector<LocationEntry> entries;
+    unordered_map<int, int> byId;                 ///< ID -> entry
+    unordered_map<string, int> byCode;            ///< code -> entry
+    vector<pair<string, int>> byName;             ///< (folded name, entry), sorted
+
+    // grid over the located entries, in equirectangular coordinates
+    double minX = 0, minY = 0, cell = 1, xScale = 1;
+    int cols = 0, rows = 0;
+    vector<int> cellStart;                        ///< size cols * rows + 1
+    vector<int> cellEntries;                      ///< entries, grouped by cell
+
+    int cellOf(double v, double min, int n) const {
+        int c = (int) ((v - min) / cell);
+        return c < 0 ? 0 : (c >= n ? n - 1 : c);
+    }
+};
+
+inline bool LocationResolver::load(const string &path) {
+    MemoryScope scope(MEM_LOADER);
+    ifstream file(path);
+    if (!file.is_open()) return false;
+    vector<string> lines;
+    string line;
+    while (getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        lines.push_back(line);
+    }
+    load(lines);
+    return true;
+}
+
+inline void LocationResolver::load(const vector<string> &lines) {
+    MemoryScope scope(MEM_LOADER);
+    entries.clear();
+    string field;
+    vector<string> fields;
+    auto split = [&](const string &l) {
+        fields.clear();
+        stringstream ss(l);
+        while (getline(ss, field, ',')) fields.push_back(field);
+    };
+    auto number = [](const string &f, double &v) { // the whole field must be a number
+        char *end;
+        v = strtod(f.c_str(), &end);
+        return !f.empty() && *end == 0 && isfinite(v);
+    };
+
+    int lat = -1, lon = -1;
+    if (!lines.empty()) {
+        split(lines[0]);
+        for (size_t i = 0; i < fields.size(); i++) {
+            string h = foldName(fields[i]);
+            if (h == "latitude" || h == "lat") lat = i;
+            else if (h == "longitude" || h == "lon" || h == "lng") lon = i;
+        }
+    }
+    for (size_t i = 1; i < lines.size(); i++) {
+        LocationEntry e;
+        if (!parseLocationRow(lines[i], e.code, e.id, e.parking)) continue; // skipped by the loaders too
+        split(lines[i]);
+        e.name = fields.empty() ? string() : fields[0];
+        e.hasCoords = lat >= 0 && lon >= 0 && lat < (int) fields.size() && lon < (int) fields.size() &&
+                      number(fields[lat], e.lat) && number(fields[lon], e.lon);
+        if (!e.hasCoords) e.lat = e.lon = 0;
+        entries.push_back(e);
+    }
+    build();
+}
+
+inline void LocationResolver::build() {
+    MemoryScope scope(MEM_LOADER);
+    byId.clear();
+    byCode.clear();
+    byName.clear();
+    vector<int> located;
+    double maxX = 0, maxY = 0, latSum = 0;
+    for (int i = 0; i < (int) entries.size(); i++) {
+        byId[entries[i].id] = i;
+        if (!entries[i].code.empty()) byCode[entries[i].code] = i;
+        byName.push_back({foldName(entries[i].name), i});
+        if (entries[i].hasCoords) {
+            located.push_back(i);
+            latSum += entries[i].lat;
+        }
+    }
+    sort(byName.begin(), byName.end());
+
+    cols = rows = 0;
+    cellStart.clear();
+    cellEntries.clear();
+    if (located.empty()) return;
+    xScale = cos(latSum / located.size() * M_PI / 180); // shrink longitudes to match latitudes
+    bool first = true;
+    for (int i : located) {
+        double x = entries[i].lon * xScale, y = entries[i].lat;
+        if (first || x < minX) minX = x;
+        if (first || y < minY) minY = y;
+        if (first || x > maxX) maxX = x;
+        if (first || y > maxY) maxY = y;
+        first = false;
+    }
+    double w = max(maxX - minX, 1e-9), h = max(maxY - minY, 1e-9);
+    cell = max(sqrt(w * h / located.size()), 1e-9); // about one location per cell
+    cols = min((int) (w / cell) + 1, 4096);
+    rows = min((int) (h / cell) + 1, 4096);
+    cell = max(w / cols, h / rows) * (1 + 1e-9);
+
+    vector<int> cellOfEntry(located.size());
+    cellStart.assign(cols * rows + 1, 0);
+    for (size_t k = 0; k < located.size(); k++) {
+        const LocationEntry &e = entries[located[k]];
+        cellOfEntry[k] = cellOf(e.lat, minY, rows) * cols + cellOf(e.lon * xScale, minX, cols);
+        cellStart[cellOfEntry[k] + 1]++;
+    }
+    for (int c = 0; c < cols * rows; c++) cellStart[c + 1] += cellStart[c];
+    cellEntries.resize(located.size());
+    vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (size_t k = 0; k < located.size(); k++) cellEntries[fill[cellOfEntry[k]]++] = located[k];
+}
+
+inline vector<const LocationEntry *> LocationResolver::findPrefix(const string &prefix, size_t limit) const {
+    vector<const LocationEntry *> res;
+    string p = foldName(prefix);
+    auto it = lower_bound(byName.begin(), byName.end(), make_pair(p, -1));
+    for (; it != byName.end() && res.size() < limit && it->first.compare(0, p.size(), p) == 0; it++)
+        res.push_back(&entries[it->second]);
+    return res;
+}
+
+inline const LocationEntry *LocationResolver::nearest(double lat, double lon) const {
+    if (cols == 0) return nullptr;
+    double x = lon * xScale, y = lat;
+    int cx = cellOf(x, minX, cols), cy = cellOf(y, minY, rows);
+    const LocationEntry *best = nullptr;
+    double bestD = 0;
+    for (int r = 0; r < max(cols, rows); r++) {
+        // the locations not visited yet, in rings r and beyond, are at least r - 1 cells away
+        double reach = (r - 1) * cell;
+        if (best != nullptr && r > 0 && bestD <= reach * reach) break;
+        for (int gy = cy - r; gy <= cy + r; gy++) {
+            if (gy < 0 || gy >= rows) continue;
+            bool edgeRow = gy == cy - r || gy == cy + r;
+            for (int gx = cx - r; gx <= cx + r; gx += edgeRow ? 1 : 2 * r) {
+                if (gx >= 0 && gx < cols) {
+                    for (int k = cellStart[gy * cols + gx]; k < cellStart[gy * cols + gx + 1]; k++) {
+                        const LocationEntry &e = entries[cellEntries[k]];
+                        double dx = e.lon * xScale - x, dy = e.lat - y, d = dx * dx + dy * dy;
+                        if (best == nullptr || d < bestD) {
+                            best = &e;
+                            bestD = d;
+                        }
+                    }
+                }
+                if (r == 0) break;
+            }
+        }
+    }
+    return best;
+}
+
+inline bool LocationResolver::resolve(const string &token, int &id, string &err) const {
+    size_t b = token.find_first_not_of(" \t"), e = token.find_last_not_of(" \t");
+    if (b == string::npos) {
+        err = "empty location";
+        return false;
+    }
+    string t = token.substr(b, e - b + 1);
+
+    if (t[0] == '@') { // coordinates
+        char *end;
+        double lat = strtod(t.c_str() + 1, &end);
+        if (*end == ',') {
+            char *end2;
+            double lon = strtod(end + 1, &end2);
+            if (end2 != end + 1 && *end2 == 0) {
+                const LocationEntry *n = nearest(lat, lon);
+                if (n == nullptr) {
+                    err = "no coordinates loaded to snap '" + t + "'";
+                    return false;
+                }
+                id = n->id;
+                return true;
+            }
+        }
+        err = "invalid coordinates '" + t + "' (expected @latitude,longitude)";
+        return false;
+    }
+
+    if (t.find_first_not_of("0123456789") == string::npos && t.size() < 10) {
+        if (findId(atoi(t.c_str())) != nullptr) {
+            id = atoi(t.c_str());
+            return true;
+        }
+    }
+    if (const LocationEntry *c = findCode(t)) {
+        id = c->id;
+        return true;
+    }
+
+    vector<const LocationEntry *> matches = findPrefix(t, 6);
+    string f = foldName(t);
+    if (!matches.empty() && foldName(matches[0]->name) == f &&
+        (matches.size() == 1 || foldName(matches[1]->name) != f)) {
+        id = matches[0]->id; // exact name, even if it is also a prefix of others
+        return true;
+    }
+    if (matches.size() == 1) {
+        id = matches[0]->id;
+        return true;
+    }
+    if (matches.empty()) {
+        err = "unknown location '" + t + "'";
+        return false;
+    }
+    err = "ambiguous location '" + t + "' (";
+    for (size_t i = 0; i < matches.size() && i < 5; i++)
+        err += (i > 0 ? ", " : "") + matches[i]->name;
+    err += matches.size() > 5 ? ", ...)" : ")";
+    return false;
+}
+
+#endif //LOCATIONRESOLVER_H
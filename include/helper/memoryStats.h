@@ -0,0 +1,145 @@
+/**
+ * @file memoryStats.h
+ * @brief Heap accounting per subsystem, per query and at peak.
+ * @details Built with BESTROUTE_MEMORY_HOOKS defined (make memstats), the global
+ * operator new and delete are replaced (memoryStats.cpp): every allocation carries a
+ * small header with its size and the subsystem that made it, so a block is credited
+ * back to the same subsystem when it is freed, whichever code frees it.
+ *
+ * The subsystem is a thread-local tag set by MemoryScope guards. The loader, the
+ * parsers, Graph, MutablePriorityQueue and the searches open one; the innermost scope
+ * wins, so the vertices created while loading count as MEM_GRAPH and the strings of
+ * the csv parser as MEM_LOADER. Allocations outside any scope count as MEM_OTHER.
+ *
+ * Without the flag, MemoryScope is an empty object, memoryUsage returns zeros and
+ * nothing is hooked, so the instrumentation costs nothing. The peak resident set size
+ * (from getrusage) is reported either way.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+#include <ostream>
+using namespace std;
+
+/**
+ * @brief Parts of the program whose allocations are counted separately.
+ */
+enum MemSubsystem {
+    MEM_OTHER,
+    MEM_LOADER,
+    MEM_GRAPH,
+    MEM_QUEUE,
+    MEM_PARSER,
+    MEM_SEARCH,
+    MEM_SUBSYSTEMS ///< number of subsystems
+};
+
+/**
+ * @brief Name of a subsystem, for reports.
+ */
+inline const char *subsystemName(int s) {
+    static const char *const names[MEM_SUBSYSTEMS] = {"other", "loader", "graph", "queue", "parser", "search"};
+    return s >= 0 && s < MEM_SUBSYSTEMS ? names[s] : "unknown";
+}
+
+/**
+ * @brief Counters of one subsystem.
+ */
+struct MemCounters {
+    long long allocs = 0;    ///< allocations made
+    long long frees = 0;     ///< allocations freed
+    long long allocated = 0; ///< bytes allocated in total
+    long long current = 0;   ///< bytes allocated and not yet freed
+    long long peak = 0;      ///< highest value of current
+};
+
+/**
+ * @brief Counters of every subsystem and of the whole heap at one point in time.
+ */
+struct MemoryUsage {
+    MemCounters subsystem[MEM_SUBSYSTEMS];
+    MemCounters total;
+    long long markPeak = 0; ///< highest value of total.current since the last memoryMark
+};
+
+/**
+ * @brief Whether this build counts allocations (BESTROUTE_MEMORY_HOOKS).
+ */
+bool memoryHooksEnabled();
+
+/**
+ * @brief Current value of the counters (all zero without hooks).
+ */
+MemoryUsage memoryUsage();
+
+/**
+ * @brief Current value of the counters, starting a new high-water mark (markPeak) at the
+ * current heap size.
+ * @details Marks do not nest: each one restarts the mark of the previous one.
+ */
+MemoryUsage memoryMark();
+
+/**
+ * @brief Peak resident set size of the process, in bytes.
+ */
+long long peakResidentBytes();
+
+/**
+ * @brief Writes a table of the counters per subsystem, the heap peak and the peak RSS.
+ */
+void printMemoryReport(ostream &out, const MemoryUsage &usage);
+
+/**
+ * @brief Allocations and bytes made between two points, for a per-query report.
+ * @details The peak is the highest heap size between the two points, above the heap
+ * size at the first one; it requires before to come from memoryMark (otherwise it
+ * covers everything since the last mark).
+ */
+inline MemCounters memoryDelta(const MemoryUsage &before, const MemoryUsage &after) {
+    MemCounters d;
+    d.allocs = after.total.allocs - before.total.allocs;
+    d.frees = after.total.frees - before.total.frees;
+    d.allocated = after.total.allocated - before.total.allocated;
+    d.current = after.total.current - before.total.current;
+    d.peak = after.markPeak - before.total.current;
+    return d;
+}
+
+#ifdef BESTROUTE_MEMORY_HOOKS
+
+/**
+ * @brief Subsystem charged for the allocations of the calling thread.
+ */
+MemSubsystem &currentSubsystem();
+
+/**
+ * @brief Charges the allocations of the calling thread to a subsystem while in scope.
+ */
+class MemoryScope {
+public:
+    explicit MemoryScope(MemSubsystem s) : saved(currentSubsystem()) {
+        currentSubsystem() = s;
+    }
+    ~MemoryScope() {
+        currentSubsystem() = saved;
+    }
+    MemoryScope(const MemoryScope &) = delete;
+    MemoryScope &operator=(const MemoryScope &) = delete;
+
+private:
+    MemSubsystem saved;
+};
+
+#else
+
+class MemoryScope {
+public:
+    explicit MemoryScope(MemSubsystem) {}
+};
+
+#endif
+
+#endif //MEMORYSTATS_H
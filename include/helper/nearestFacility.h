@@ -0,0 +1,227 @@
+/**
+ * @file nearestFacility.h
+ * @brief Nearest-facility queries (e.g. nearest parking) with multi-source Dijkstra.
+ * @details Instead of one dijkstra per location, the heap is seeded with every
+ * facility at distance 0 and a single pass labels each vertex with its nearest facility
+ * and the distance to it, i.e. the Voronoi cells of the facilities on the graph. The
+ * search runs on the reversed graph when distances towards the facilities are wanted
+ * ("nearest parking to each destination"). A variant keeps the k nearest facilities of
+ * every vertex. Cells depend only on the graph and the facility set, so they can be
+ * saved to a binary file and reused.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef NEARESTFACILITY_H
+#define NEARESTFACILITY_H
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <queue>
+#include <tuple>
+#include <functional>
+#include <algorithm>
+#include "../data_structs/CSRGraph.h"
+#include "csrDijkstra.h"
+using namespace std;
+
+#define VORONOI_MAGIC 0x31524f56u // "VOR1"
+
+/**
+ * @brief Voronoi cells of a set of facilities.
+ */
+struct VoronoiCells {
+    vector<int> nearest;     ///< slot -> nearest facility slot (-1 if none is reachable)
+    vector<int> dist;        ///< slot -> distance to/from that facility (INT_INF if none)
+    vector<int> via;         ///< slot -> next slot towards the facility along the search (-1 at facilities)
+    bool toFacility = true;  ///< distances are measured from the vertex to the facility
+};
+
+/**
+ * @brief The k nearest facilities of every vertex, in flat arrays.
+ */
+struct NearestFacilities {
+    int k = 0;
+    vector<int> facility; ///< slot * k + i -> i-th nearest facility slot (-1 if fewer are reachable)
+    vector<int> dist;     ///< slot * k + i -> its distance (INT_INF if none)
+};
+
+/**
+ * @brief Slots of the vertices that have parking.
+ * @complexity O(V).
+ */
+inline vector<int> parkingSlots(const CSRGraph<int> &g) {
+    vector<int> res;
+    for (int v = 0; v < g.getNumVertex(); v++)
+        if (g.hasParking(v)) res.push_back(v);
+    return res;
+}
+
+/**
+ * @brief Multi-source Dijkstra: every vertex gets its nearest source.
+ * @param g Graph to search (already reversed for distances towards the sources).
+ * @param sources Source slots.
+ * @param cells Receives nearest, dist and via; toFacility is left untouched.
+ * @complexity O((V + E) log V), independently of the number of sources.
+ */
+inline void multiSourceDijkstra(const CSRGraph<int> &g, const vector<int> &sources, VoronoiCells &cells) {
+    int n = g.getNumVertex();
+    cells.nearest.assign(n, -1);
+    cells.dist.assign(n, INT_INF);
+    cells.via.assign(n, -1);
+
+    typedef pair<int, int> Entry; // (distance, slot)
+    priority_queue<Entry, vector<Entry>, greater<Entry>> q;
+    for (int s : sources) {
+        if (s < 0 || s >= n || cells.dist[s] == 0) continue;
+        cells.dist[s] = 0;
+        cells.nearest[s] = s;
+        q.push({0, s});
+    }
+    while (!q.empty()) {
+        Entry top = q.top();
+        q.pop();
+        int u = top.second;
+        if (top.first != cells.dist[u]) continue; // stale entry
+        for (int e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+            int v = g.getTarget(e), nd = top.first + g.getWeight(e);
+            if (nd < cells.dist[v]) {
+                cells.dist[v] = nd;
+                cells.nearest[v] = cells.nearest[u];
+                cells.via[v] = u;
+                q.push({nd, v});
+            }
+        }
+    }
+}
+
+/**
+ * @brief Computes the Voronoi cells of a set of facilities.
+ * @param g CSR graph.
+ * @param facilities Facility slots (e.g. parkingSlots(g)).
+ * @param cells Receives the cells.
+ * @param toFacility True for distances from each vertex to its nearest facility,
+ * false for distances from the nearest facility to each vertex.
+ * @complexity O((V + E) log V), plus O(V + E) to reverse the graph when toFacility is set.
+ */
+inline void voronoiCells(const CSRGraph<int> &g, const vector<int> &facilities, VoronoiCells &cells,
+                         bool toFacility = true) {
+    if (toFacility) multiSourceDijkstra(g.reversed(), facilities, cells);
+    else multiSourceDijkstra(g, facilities, cells);
+    cells.toFacility = toFacility;
+}
+
+/**
+ * @brief Path between a vertex and its nearest facility.
+ * @param g CSR graph the cells were computed on.
+ * @param cells Voronoi cells.
+ * @param slot Vertex slot.
+ * @return Vertex IDs, from slot to the facility if cells.toFacility, from the facility
+ * to slot otherwise; empty if no facility is reachable.
+ * @complexity O(P), where P is the number of vertices in the path.
+ */
+inline vector<int> facilityPath(const CSRGraph<int> &g, const VoronoiCells &cells, int slot) {
+    vector<int> res;
+    if (slot < 0 || slot >= (int) cells.nearest.size() || cells.nearest[slot] == -1) return res;
+    for (int v = slot; v != -1; v = cells.via[v])
+        res.push_back(g.getInfo(v));
+    if (!cells.toFacility) reverse(res.begin(), res.end());
+    return res;
+}
+
+/**
+ * @brief The k nearest distinct facilities of every vertex, in a single search.
+ * @details Heap entries carry their facility; a vertex accepts at most k entries, one
+ * per facility, in order of distance. The entries it accepts are exactly its k nearest
+ * facilities.
+ *
+ * @param g CSR graph.
+ * @param facilities Facility slots.
+ * @param k Number of facilities per vertex.
+ * @param toFacility Direction of the distances (see voronoiCells).
+ * @return The k nearest facilities of every slot, nearest first.
+ * @complexity O(k (V + E) log(k V)).
+ */
+inline NearestFacilities kNearestFacilities(const CSRGraph<int> &g, const vector<int> &facilities, int k,
+                                            bool toFacility = true) {
+    NearestFacilities res;
+    int n = g.getNumVertex();
+    res.k = max(k, 0);
+    res.facility.assign((size_t) n * res.k, -1);
+    res.dist.assign((size_t) n * res.k, INT_INF);
+    if (res.k == 0) return res;
+
+    CSRGraph<int> rev;
+    if (toFacility) rev = g.reversed();
+    const CSRGraph<int> &h = toFacility ? rev : g;
+
+    vector<int> count(n, 0);
+    typedef tuple<int, int, int> Entry; // (distance, slot, facility)
+    priority_queue<Entry, vector<Entry>, greater<Entry>> q;
+    for (int s : facilities)
+        if (s >= 0 && s < n) q.push(make_tuple(0, s, s));
+
+    while (!q.empty()) {
+        int d, u, f;
+        tie(d, u, f) = q.top();
+        q.pop();
+        int *fac = &res.facility[(size_t) u * res.k];
+        if (count[u] == res.k || find(fac, fac + count[u], f) != fac + count[u]) continue;
+        fac[count[u]] = f;
+        res.dist[(size_t) u * res.k + count[u]] = d;
+        count[u]++;
+        for (int e = h.edgeBegin(u); e < h.edgeEnd(u); e++) {
+            int v = h.getTarget(e);
+            if (count[v] < res.k) q.push(make_tuple(d + h.getWeight(e), v, f));
+        }
+    }
+    return res;
+}
+
+/**
+ * @brief Writes Voronoi cells to a binary file, so they can be reused by later runs.
+ * @complexity O(V).
+ */
+inline bool saveCells(const string &path, const VoronoiCells &cells) {
+    FILE *f = fopen(path.c_str(), "wb");
+    if (f == nullptr) return false;
+    uint32_t n = cells.nearest.size();
+    uint32_t header[3] = {VORONOI_MAGIC, n, cells.toFacility ? 1u : 0u};
+    bool ok = fwrite(header, sizeof(uint32_t), 3, f) == 3;
+    ok = ok && fwrite(cells.nearest.data(), sizeof(int), n, f) == n;
+    ok = ok && fwrite(cells.dist.data(), sizeof(int), n, f) == n;
+    ok = ok && fwrite(cells.via.data(), sizeof(int), n, f) == n;
+    return fclose(f) == 0 && ok;
+}
+
+/**
+ * @brief Reads Voronoi cells written by saveCells.
+ * @param path File path.
+ * @param cells Receives the cells.
+ * @param numVertex Expected number of vertices; the file is rejected if it differs.
+ * @return False if the file is missing, invalid or was computed for another graph size.
+ * @complexity O(V).
+ */
+inline bool loadCells(const string &path, VoronoiCells &cells, int numVertex) {
+    FILE *f = fopen(path.c_str(), "rb");
+    if (f == nullptr) return false;
+    uint32_t header[3];
+    bool ok = fread(header, sizeof(uint32_t), 3, f) == 3 && header[0] == VORONOI_MAGIC &&
+              header[1] == (uint32_t) numVertex;
+    if (ok) {
+        cells.nearest.resize(numVertex);
+        cells.dist.resize(numVertex);
+        cells.via.resize(numVertex);
+        cells.toFacility = header[2] != 0;
+        ok = fread(cells.nearest.data(), sizeof(int), numVertex, f) == (size_t) numVertex &&
+             fread(cells.dist.data(), sizeof(int), numVertex, f) == (size_t) numVertex &&
+             fread(cells.via.data(), sizeof(int), numVertex, f) == (size_t) numVertex &&
+             fgetc(f) == EOF;
+    }
+    fclose(f);
+    return ok;
+}
+
+#endif //NEARESTFACILITY_H
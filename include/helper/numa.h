@@ -0,0 +1,194 @@
+/**
+ * @file numa.h
+ * @brief NUMA topology, per-node graph replicas and socket-pinned query threads.
+ * @details On a multi-socket host, memory is allocated on the node of the thread that
+ * first touches it. Everything loadGraphs and the CSR constructor allocate therefore
+ * sits on the loading thread's node, and searches running on the other sockets pay
+ * the remote access latency for every edge they relax.
+ *
+ * NumaReplicas keeps one copy of a read-only CSRGraph per node. Each copy is made by a
+ * thread pinned to the CPUs of its node, so its arrays are first touched, and placed,
+ * there; no libnuma is needed. forEachWorker then runs query threads pinned to the
+ * CPUs of each node, and every worker only reads its own node's replica.
+ *
+ * The topology is read from /sys/devices/system/node. Hosts without it (or non-Linux
+ * systems) are treated as a single node holding every CPU; pinning is then skipped.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <memory>
+#include <algorithm>
+#include <cstdlib>
+#include <dirent.h>
+#include "../data_structs/CSRGraph.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief A NUMA node and the CPUs it holds.
+ */
+struct NumaNode {
+    int id = 0;
+    vector<int> cpus;
+};
+
+/**
+ * @brief Parses a kernel CPU list such as "0-3,8,10-11".
+ * @return The CPU numbers, in the order listed; empty if the list is malformed.
+ * @complexity O(L + C), for L characters and C CPUs.
+ */
+inline vector<int> parseCpuList(const string &list) {
+    vector<int> cpus;
+    const char *p = list.c_str();
+    while (*p != 0 && *p != '\n') {
+        char *end;
+        long first = strtol(p, &end, 10), last = first;
+        if (end == p || first < 0) return vector<int>();
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            if (end == p + 1 || last < first) return vector<int>();
+            p = end;
+        }
+        for (long c = first; c <= last; c++) cpus.push_back((int) c);
+        if (*p == ',') p++;
+        else if (*p != 0 && *p != '\n') return vector<int>();
+    }
+    return cpus;
+}
+
+/**
+ * @brief Reads the NUMA nodes with CPUs from sysfs.
+ * @return The nodes in increasing ID order; a single node with every CPU if the
+ * topology is not available.
+ * @complexity O(N + C), for N nodes and C CPUs.
+ */
+inline vector<NumaNode> numaTopology() {
+    vector<NumaNode> nodes;
+    const string base = "/sys/devices/system/node/";
+    DIR *dir = opendir(base.c_str());
+    if (dir != nullptr) {
+        while (dirent *entry = readdir(dir)) {
+            string name = entry->d_name;
+            if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+                name.find_first_not_of("0123456789", 4) != string::npos) continue;
+            ifstream in(base + name + "/cpulist");
+            string list;
+            if (!getline(in, list)) continue;
+            NumaNode node;
+            node.id = atoi(name.c_str() + 4);
+            node.cpus = parseCpuList(list);
+            if (!node.cpus.empty()) nodes.push_back(node);
+        }
+        closedir(dir);
+    }
+    if (nodes.empty()) {
+        NumaNode all;
+        unsigned n = thread::hardware_concurrency();
+        for (unsigned c = 0; c < (n > 0 ? n : 1); c++) all.cpus.push_back(c);
+        nodes.push_back(all);
+    }
+    sort(nodes.begin(), nodes.end(), [](const NumaNode &a, const NumaNode &b) { return a.id < b.id; });
+    return nodes;
+}
+
+/**
+ * @brief Restricts the calling thread to a set of CPUs.
+ * @return True if the affinity was set.
+ * @complexity O(C).
+ */
+inline bool pinThisThread(const vector<int> &cpus) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus)
+        if (c >= 0 && c < CPU_SETSIZE) CPU_SET(c, &set);
+    return CPU_COUNT(&set) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void) cpus;
+    return false;
+#endif
+}
+
+/**
+ * @brief One copy of a read-only CSR graph per NUMA node.
+ * @tparam T Type of the graph vertices.
+ */
+template <class T>
+class NumaReplicas {
+public:
+    /**
+     * @brief Copies the graph once per node, each copy on a thread pinned to that node.
+     * @details With a single node, the only replica is still a copy, so the source
+     * graph can be released afterwards.
+     * @complexity O(N (V + E)), with the N copies made in parallel.
+     */
+    explicit NumaReplicas(const CSRGraph<T> &g, const vector<NumaNode> &topology = numaTopology())
+        : nodes(topology), replicas(topology.size()) {
+        vector<thread> pool;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            pool.emplace_back([this, &g, i]() {
+                pinThisThread(nodes[i].cpus);
+                replicas[i].reset(new CSRGraph<T>(g)); // first touch on node i
+            });
+        }
+        for (auto &t : pool) t.join();
+    }
+
+    int getNumNodes() const {
+        return nodes.size();
+    }
+
+    const NumaNode &getNode(int i) const {
+        return nodes[i];
+    }
+
+    /**
+     * @brief The replica placed on the i-th node.
+     */
+    const CSRGraph<T> &getReplica(int i) const {
+        return *replicas[i];
+    }
+
+    /**
+     * @brief Runs pinned worker threads on every node.
+     * @details Calls f(replica, node, worker) on threadsPerNode threads per node (one per
+     * CPU of the node if 0), each pinned to the CPUs of its node and given that node's
+     * replica. Workers are numbered from 0 across all nodes. Returns when all finish.
+     * @complexity O(T) threads, plus the work done by f.
+     */
+    template <class F>
+    void forEachWorker(unsigned threadsPerNode, F f) const {
+        vector<thread> pool;
+        unsigned worker = 0;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            unsigned count = threadsPerNode > 0 ? threadsPerNode : nodes[i].cpus.size();
+            for (unsigned k = 0; k < count; k++, worker++) {
+                pool.emplace_back([this, &f, i, worker]() {
+                    pinThisThread(nodes[i].cpus);
+                    f(*replicas[i], (unsigned) i, worker);
+                });
+            }
+        }
+        for (auto &t : pool) t.join();
+    }
+
+private:
+    vector<NumaNode> nodes;
+    vector<unique_ptr<CSRGraph<T>>> replicas;
+};
+
+#endif //NUMA_H
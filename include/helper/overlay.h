@@ -0,0 +1,364 @@
+/**
+ * @file overlay.h
+ * @brief Partition + overlay routing (CRP style) with fast re-customization.
+ * @details Preprocessing is split in two phases:
+ * - Partition (metric-independent): the vertices are split into cells of bounded size by
+ *   recursive bisection, using only the topology of the graph.
+ * - Customization (metric-dependent): for every cell, the distances between its entry
+ *   vertices (reached by an edge from another cell) and its exit vertices (with an edge to
+ *   another cell) are computed with edges inside the cell only. Cells are independent, so
+ *   they are customized in parallel, and after weight changes only the cells that contain
+ *   a changed edge are recomputed.
+ *
+ * A query runs Dijkstra on the original edges inside the source and destination cells and
+ * on the cell cliques plus the edges between cells everywhere else. Clique shortcuts are
+ * expanded back into the full vertex sequence on the way out.
+ *
+ * This is a single overlay level, which already keeps searches small on networks of the
+ * size of data/; cells can be made larger for bigger networks.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include "../data_structs/CSRGraph.h"
+#include "csrDijkstra.h"
+using namespace std;
+
+/**
+ * @brief Metric-independent partition of a CSRGraph into cells.
+ * @details Recursive bisection: a set is ordered by BFS (ignoring edge directions) from a
+ * pseudo-peripheral vertex and cut in two halves, until every cell has at most maxCellSize
+ * vertices. Cutting a BFS order keeps the cells connected and their boundaries small.
+ *
+ * @param g CSR graph.
+ * @param maxCellSize Maximum number of vertices per cell.
+ * @return slot -> cell number.
+ * @complexity O((V + E) log(V / maxCellSize)).
+ */
+inline vector<int> partitionGraph(const CSRGraph<int> &g, int maxCellSize) {
+    int n = g.getNumVertex();
+    vector<vector<int>> nb(n);
+    for (int u = 0; u < n; u++) {
+        for (int e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+            nb[u].push_back(g.getTarget(e));
+            nb[g.getTarget(e)].push_back(u);
+        }
+    }
+
+    vector<int> cell(n, -1), mark(n, -1), dist(n, -1);
+    int cells = 0, stamp = 0;
+    vector<vector<int>> work;
+    vector<int> all(n);
+    for (int i = 0; i < n; i++) all[i] = i;
+    work.push_back(all);
+
+    // BFS order of a set (marked with the current stamp), restarting for every component
+    auto bfsOrder = [&](const vector<int> &set, int start, vector<int> &order) {
+        order.clear();
+        for (int v : set) dist[v] = -1;
+        for (size_t k = 0; k <= set.size() && order.size() < set.size(); k++) {
+            int s = k == 0 ? start : set[k - 1];
+            if (dist[s] != -1) continue;
+            dist[s] = 0;
+            size_t head = order.size();
+            order.push_back(s);
+            while (head < order.size()) {
+                int u = order[head++];
+                for (int v : nb[u]) {
+                    if (mark[v] == stamp && dist[v] == -1) {
+                        dist[v] = dist[u] + 1;
+                        order.push_back(v);
+                    }
+                }
+            }
+        }
+    };
+
+    vector<int> order;
+    while (!work.empty()) {
+        vector<int> set = work.back();
+        work.pop_back();
+        if ((int) set.size() <= maxCellSize) {
+            for (int v : set) cell[v] = cells;
+            cells++;
+            continue;
+        }
+        stamp++;
+        for (int v : set) mark[v] = stamp;
+        bfsOrder(set, set[0], order);
+        bfsOrder(set, order.back(), order); // start again from the farthest vertex
+        size_t half = order.size() / 2;
+        work.push_back(vector<int>(order.begin(), order.begin() + half));
+        work.push_back(vector<int>(order.begin() + half, order.end()));
+    }
+    return cell;
+}
+
+/**
+ * @brief Overlay graph over a partition, with a replaceable metric.
+ */
+class OverlayGraph {
+public:
+    /*
+     * Builds the overlay topology of g over the given partition (slot -> cell).
+     * The metric starts as the weights of g; call customize() before querying.
+     */
+    OverlayGraph(const CSRGraph<int> &g, const vector<int> &cellOf);
+
+    /*
+     * Changes the weight of an edge (INT_INF closes it). Only marks its cell as dirty.
+     */
+    void setWeight(int edge, int w);
+    int getWeight(int edge) const;
+
+    /*
+     * Recomputes the cliques of the dirty cells (all cells the first time), using up to
+     * 'threads' threads (0 = hardware concurrency). Returns the number of cells customized.
+     */
+    int customize(unsigned threads = 0);
+
+    /*
+     * Shortest route between two vertex IDs with the current metric.
+     * Returns the vertex IDs of the route (empty if there is none) and its weight in w.
+     */
+    vector<int> route(int source, int dest, int &w) const;
+
+    int getNumCells() const;
+
+protected:
+    const CSRGraph<int> &g;
+    vector<int> weights;       // current metric, by edge ID
+    vector<int> origin;        // edge -> origin slot
+    vector<int> cellOf;        // slot -> cell
+    vector<int> localIdx;      // slot -> index inside its cell
+    vector<int> entryIdx;      // slot -> index among its cell's entries (-1 if none)
+    vector<int> exitIdx;       // slot -> index among its cell's exits (-1 if none)
+    vector<vector<int>> members, entries, exits; // per cell
+    vector<size_t> cliqueOff;  // cell -> first entry of its clique in cliqueDist
+    vector<int> cliqueDist;    // entries x exits distances, row-major per cell
+    vector<char> dirty;
+
+    void customizeCell(int c, vector<int> &dist);
+    void cellPath(int c, int from, int to, vector<int> &slots) const;
+};
+
+inline OverlayGraph::OverlayGraph(const CSRGraph<int> &g, const vector<int> &cellOf)
+    : g(g), weights(g.getWeights()), origin(g.getNumEdges()), cellOf(cellOf),
+      localIdx(g.getNumVertex()), entryIdx(g.getNumVertex(), -1), exitIdx(g.getNumVertex(), -1) {
+    int n = g.getNumVertex();
+    int cells = n == 0 ? 0 : *max_element(cellOf.begin(), cellOf.end()) + 1;
+    members.resize(cells);
+    entries.resize(cells);
+    exits.resize(cells);
+    for (int u = 0; u < n; u++) {
+        localIdx[u] = members[cellOf[u]].size();
+        members[cellOf[u]].push_back(u);
+        for (int e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+            origin[e] = u;
+            int v = g.getTarget(e);
+            if (cellOf[v] == cellOf[u]) continue;
+            if (exitIdx[u] == -1) {
+                exitIdx[u] = exits[cellOf[u]].size();
+                exits[cellOf[u]].push_back(u);
+            }
+            if (entryIdx[v] == -1) {
+                entryIdx[v] = -2; // numbered below, in slot order
+            }
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        if (entryIdx[v] == -2) {
+            entryIdx[v] = entries[cellOf[v]].size();
+            entries[cellOf[v]].push_back(v);
+        }
+    }
+    cliqueOff.resize(cells + 1, 0);
+    for (int c = 0; c < cells; c++)
+        cliqueOff[c + 1] = cliqueOff[c] + entries[c].size() * exits[c].size();
+    cliqueDist.assign(cliqueOff[cells], INT_INF);
+    dirty.assign(cells, 1);
+}
+
+inline int OverlayGraph::getNumCells() const {
+    return members.size();
+}
+
+inline int OverlayGraph::getWeight(int edge) const {
+    return weights[edge];
+}
+
+inline void OverlayGraph::setWeight(int edge, int w) {
+    weights[edge] = w;
+    int u = origin[edge], v = g.getTarget(edge);
+    if (cellOf[u] == cellOf[v]) dirty[cellOf[u]] = 1; // edges between cells are used directly
+}
+
+/**
+ * @brief Computes the clique of one cell: a Dijkstra from every entry, inside the cell.
+ * @param dist Scratch array with one entry per slot, all INT_INF.
+ * @complexity O(A (V_c + E_c) log V_c), for A entries.
+ */
+inline void OverlayGraph::customizeCell(int c, vector<int> &dist) {
+    typedef pair<int, int> Entry;
+    int *row = cliqueDist.data() + cliqueOff[c];
+    for (size_t a = 0; a < entries[c].size(); a++) {
+        priority_queue<Entry, vector<Entry>, greater<Entry>> q;
+        dist[entries[c][a]] = 0;
+        q.push({0, entries[c][a]});
+        while (!q.empty()) {
+            Entry top = q.top();
+            q.pop();
+            int u = top.second;
+            if (top.first > dist[u]) continue;
+            for (int e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+                int v = g.getTarget(e);
+                if (cellOf[v] != c || weights[e] >= INT_INF) continue;
+                int nd = top.first + weights[e];
+                if (nd < dist[v]) {
+                    dist[v] = nd;
+                    q.push({nd, v});
+                }
+            }
+        }
+        for (size_t x = 0; x < exits[c].size(); x++)
+            row[a * exits[c].size() + x] = dist[exits[c][x]];
+        for (int v : members[c]) dist[v] = INT_INF;
+    }
+}
+
+/**
+ * @brief Recomputes the dirty cells in parallel.
+ * @details Cells are handed out round-robin to the threads; each thread writes only the
+ * clique rows of its own cells, so no locking is needed.
+ * @complexity O(sum over dirty cells of A (V_c + E_c) log V_c / threads).
+ */
+inline int OverlayGraph::customize(unsigned threads) {
+    vector<int> todo;
+    for (size_t c = 0; c < dirty.size(); c++)
+        if (dirty[c]) todo.push_back(c);
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    threads = min<unsigned>(threads, max<size_t>(1, todo.size()));
+
+    auto worker = [this, &todo, threads](unsigned id) {
+        vector<int> dist(g.getNumVertex(), INT_INF);
+        for (size_t i = id; i < todo.size(); i += threads)
+            customizeCell(todo[i], dist);
+    };
+    vector<thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto &t : pool) t.join();
+
+    for (int c : todo) dirty[c] = 0;
+    return todo.size();
+}
+
+/**
+ * @brief Appends the shortest path from slot 'from' to slot 'to' inside cell c
+ * (excluding 'from') to slots. Used to expand clique shortcuts.
+ * @complexity O((V_c + E_c) log V_c).
+ */
+inline void OverlayGraph::cellPath(int c, int from, int to, vector<int> &slots) const {
+    typedef pair<int, int> Entry;
+    vector<int> dist(members[c].size(), INT_INF), pred(members[c].size(), -1);
+    priority_queue<Entry, vector<Entry>, greater<Entry>> q;
+    dist[localIdx[from]] = 0;
+    q.push({0, from});
+    while (!q.empty()) {
+        Entry top = q.top();
+        q.pop();
+        int u = top.second;
+        if (top.first > dist[localIdx[u]]) continue;
+        if (u == to) break;
+        for (int e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+            int v = g.getTarget(e);
+            if (cellOf[v] != c || weights[e] >= INT_INF) continue;
+            int nd = top.first + weights[e];
+            if (nd < dist[localIdx[v]]) {
+                dist[localIdx[v]] = nd;
+                pred[localIdx[v]] = u;
+                q.push({nd, v});
+            }
+        }
+    }
+    vector<int> rev;
+    for (int v = to; v != from; v = pred[localIdx[v]]) rev.push_back(v);
+    slots.insert(slots.end(), rev.rbegin(), rev.rend());
+}
+
+/**
+ * @brief Shortest route on the overlay.
+ * @details In the source and destination cells every original edge is used. Elsewhere a
+ * vertex reached from another cell (an entry) continues through its cell's clique, and
+ * exits continue through their edges to other cells.
+ * @complexity O((V' + E') log V'), where V' and E' are the two end cells plus the overlay.
+ */
+inline vector<int> OverlayGraph::route(int source, int dest, int &w) const {
+    vector<int> res;
+    int s = g.findSlot(source), t = g.findSlot(dest);
+    if (s < 0 || t < 0) return res;
+    int n = g.getNumVertex();
+    int cs = cellOf[s], ct = cellOf[t];
+
+    vector<int> dist(n, INT_INF), pred(n, -1);
+    vector<char> viaClique(n, 0); // pred is the entry of a clique shortcut, not an edge origin
+    typedef pair<int, int> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> q;
+    dist[s] = 0;
+    q.push({0, s});
+    while (!q.empty()) {
+        Entry top = q.top();
+        q.pop();
+        int u = top.second, d = top.first;
+        if (d > dist[u]) continue;
+        if (u == t) break;
+        int c = cellOf[u];
+        auto relax = [&](int v, int nd, bool clique) {
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                pred[v] = u;
+                viaClique[v] = clique;
+                q.push({nd, v});
+            }
+        };
+        if (c == cs || c == ct) {
+            for (int e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+                if (weights[e] < INT_INF) relax(g.getTarget(e), d + weights[e], false);
+            continue;
+        }
+        if (entryIdx[u] != -1) {
+            const int *row = cliqueDist.data() + cliqueOff[c] + entryIdx[u] * exits[c].size();
+            for (size_t x = 0; x < exits[c].size(); x++)
+                if (row[x] < INT_INF && exits[c][x] != u) relax(exits[c][x], d + row[x], true);
+        }
+        if (exitIdx[u] != -1) {
+            for (int e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+                if (cellOf[g.getTarget(e)] != c && weights[e] < INT_INF) relax(g.getTarget(e), d + weights[e], false);
+        }
+    }
+    if (dist[t] == INT_INF) return res;
+
+    w = dist[t];
+    vector<int> hops; // overlay path, destination first
+    for (int v = t; v != -1; v = pred[v]) hops.push_back(v);
+    reverse(hops.begin(), hops.end());
+    vector<int> slots;
+    slots.push_back(hops[0]);
+    for (size_t i = 1; i < hops.size(); i++) {
+        if (viaClique[hops[i]]) cellPath(cellOf[hops[i]], hops[i - 1], hops[i], slots);
+        else slots.push_back(hops[i]);
+    }
+    for (int v : slots) res.push_back(g.getInfo(v));
+    return res;
+}
+
+#endif //OVERLAY_H
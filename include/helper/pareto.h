@@ -0,0 +1,168 @@
+/**
+ * @file pareto.h
+ * @brief Multi-criteria (Pareto) routing for the drive + walk use case.
+ * @details A route starts by car on the driving graph, may park at any parking node
+ * (one transfer) and continue on foot on the walking graph; it may also walk from the
+ * start. A route that ends by car must end at a parking node (unless
+ * ParetoOptions::mustPark is off). Routes are compared by total time, walking time and number of transfers, and
+ * the search returns every route that is not dominated by another one, e.g. less
+ * walking for slightly more total time.
+ *
+ * Both modes are layers of one MultiLayerGraph, so a slot is the same location in the
+ * driving and the walking layer and parking is a change of layer at the same slot.
+ *
+ * The search is label-setting: labels live in a single pool and refer to their parent by
+ * index, and every (vertex, mode) keeps a bounded bag of non-dominated label indices.
+ * An optional epsilon-dominance relaxes the comparison to cap the number of labels.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef PARETO_H
+#define PARETO_H
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include "../data_structs/MultiLayerGraph.h"
+#include "csvLoader.h"
+using namespace std;
+
+/**
+ * @brief Options of a Pareto search.
+ */
+struct ParetoOptions {
+    unsigned maxLabels = 16;   ///< maximum labels kept per vertex and mode (0 = unbounded)
+    double epsilon = 0.0;      ///< epsilon-dominance factor (0 = exact Pareto set)
+    bool mustPark = true;      ///< a route may only end by car if the destination has parking
+};
+
+/**
+ * @brief A non-dominated drive + walk route.
+ */
+struct ParetoRoute {
+    vector<int> path;     ///< vertex IDs from source to destination
+    int total = 0;        ///< total travel time
+    int walking = 0;      ///< time spent walking
+    int transfers = 0;    ///< number of mode changes (parking)
+    int parkingNode = 0;  ///< vertex ID where the car was parked (0 if none)
+};
+
+/**
+ * @brief A label of the Pareto search, stored in a shared pool.
+ */
+struct ParetoLabel {
+    int total, walking, transfers;
+    int slot;
+    int layer;      ///< LAYER_DRIVE or LAYER_WALK
+    int parent;     ///< index of the parent label in the pool (-1 for the source)
+    bool dead;      ///< dominated after being queued
+};
+
+/**
+ * @brief Whether label a (epsilon-)dominates label b.
+ * @complexity O(1).
+ */
+inline bool paretoDominates(const ParetoLabel &a, const ParetoLabel &b, double eps) {
+    double f = 1.0 + eps;
+    return a.total <= f * b.total && a.walking <= f * b.walking && a.transfers <= b.transfers;
+}
+
+/**
+ * @brief Computes the Pareto set of drive + walk routes between two locations.
+ * @param net Network filled by loadNetwork (LAYER_DRIVE and LAYER_WALK).
+ * @param source Source vertex ID.
+ * @param destination Destination vertex ID.
+ * @param opt Label bound and epsilon.
+ * @return Non-dominated routes, by increasing total time.
+ * @complexity O(L (d + B) log L), for L labels created, d the degree and B the bag size.
+ */
+inline vector<ParetoRoute> paretoRoutes(const MultiLayerGraph<int> &net, int source, int destination,
+                                        const ParetoOptions &opt = ParetoOptions()) {
+    vector<ParetoRoute> res;
+    int s = net.findSlot(source), t = net.findSlot(destination);
+    if (s < 0 || t < 0) return res;
+
+    int n = net.getNumVertex();
+    vector<ParetoLabel> pool;
+    pool.reserve(4 * n);
+    vector<vector<int>> bags(2 * n); // state = layer * n + slot
+
+    typedef pair<pair<int, int>, int> Entry; // ((total, walking), label)
+    priority_queue<Entry, vector<Entry>, greater<Entry>> q;
+
+    auto tryAdd = [&](ParetoLabel l) {
+        vector<int> &bag = bags[l.layer * n + l.slot];
+        for (int k : bag)
+            if (paretoDominates(pool[k], l, opt.epsilon)) return;
+        size_t keep = 0;
+        for (size_t i = 0; i < bag.size(); i++) {
+            if (paretoDominates(l, pool[bag[i]], 0.0)) pool[bag[i]].dead = true;
+            else bag[keep++] = bag[i];
+        }
+        bag.resize(keep);
+        if (opt.maxLabels != 0 && bag.size() >= opt.maxLabels) return;
+        l.dead = false;
+        pool.push_back(l);
+        bag.push_back(pool.size() - 1);
+        q.push({{l.total, l.walking}, (int) pool.size() - 1});
+    };
+
+    tryAdd({0, 0, 0, s, LAYER_DRIVE, -1, false});
+    tryAdd({0, 0, 0, s, LAYER_WALK, -1, false}); // leave the car at home and walk
+
+    while (!q.empty()) {
+        int idx = q.top().second;
+        q.pop();
+        if (pool[idx].dead) continue;
+        ParetoLabel cur = pool[idx];
+        if (cur.slot == t) continue; // no need to go past the destination
+
+        const GraphLayer<int> &g = net.getLayer(cur.layer);
+        for (int e = g.edgeBegin(cur.slot); e < g.edgeEnd(cur.slot); e++) {
+            int w = g.getWeight(e);
+            tryAdd({cur.total + w, cur.walking + (cur.layer == LAYER_WALK ? w : 0), cur.transfers,
+                    g.getTarget(e), cur.layer, idx, false});
+        }
+        if (cur.layer == LAYER_DRIVE && cur.slot != s && net.hasParking(cur.slot)) { // park: same slot
+            tryAdd({cur.total, cur.walking, cur.transfers + 1, cur.slot, LAYER_WALK, idx, false});
+        }
+    }
+
+    vector<int> found;
+    for (int layer = LAYER_DRIVE; layer <= LAYER_WALK; layer++) {
+        if (layer == LAYER_DRIVE && opt.mustPark && !net.hasParking(t)) continue;
+        for (int k : bags[layer * n + t])
+            if (!pool[k].dead) found.push_back(k);
+    }
+    for (int k : found) {
+        bool dominated = false;
+        for (int j : found)
+            if (j != k && paretoDominates(pool[j], pool[k], 0.0) &&
+                (pool[j].total < pool[k].total || pool[j].walking < pool[k].walking ||
+                 pool[j].transfers < pool[k].transfers || j < k))
+                dominated = true;
+        if (dominated) continue;
+
+        ParetoRoute r;
+        r.total = pool[k].total;
+        r.walking = pool[k].walking;
+        r.transfers = pool[k].transfers;
+        for (int i = k; i != -1; i = pool[i].parent) {
+            int id = net.getInfo(pool[i].slot);
+            if (r.path.empty() || r.path.back() != id) r.path.push_back(id);
+            int p = pool[i].parent;
+            if (p != -1 && pool[p].layer == LAYER_DRIVE && pool[i].layer == LAYER_WALK) r.parkingNode = id;
+        }
+        reverse(r.path.begin(), r.path.end());
+        res.push_back(r);
+    }
+    sort(res.begin(), res.end(), [](const ParetoRoute &a, const ParetoRoute &b) {
+        return a.total < b.total || (a.total == b.total && a.walking < b.walking);
+    });
+    return res;
+}
+
+#endif //PARETO_H
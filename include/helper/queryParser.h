@@ -0,0 +1,398 @@
+/**
+ * @file queryParser.h
+ * @brief Parses routing queries from files, streams and the command line.
+ * @details Replaces the old fixed-order input loader. File input is made of keyed
+ * lines ("Key:value") in any order:
+ *
+ *     Mode:driving
+ *     Source:2
+ *     Destination:3
+ *     AvoidNodes:5,7
+ *     AvoidSegments:(1,2),(4,5)
+ *     IncludeNode:4
+ *     TimeLimit:50
+ *
+ * Keys are case-insensitive; "IncludeNodes" is accepted as an alias of "IncludeNode".
+ * TimeLimit is optional: the query's searches stop after that many milliseconds and
+ * return a best-effort result. With a LocationResolver, locations may also be given
+ * by code, name, unique name prefix or "@latitude,longitude" instead of by ID.
+ * A record ends at a blank line, at a line with "---", or when a key that was already
+ * set appears again, so one input can hold many queries. Malformed records are
+ * reported with their line number and skipped; parsing continues with the next record.
+ * Node IDs are validated against the loaded graph. Lines and lists are parsed in
+ * place, reusing the buffers of the previous record.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef QUERYPARSER_H
+#define QUERYPARSER_H
+
+#include <istream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include "../data_structs/Graph.h"
+#include "removers.h"
+#include "locationResolver.h"
+using namespace std;
+
+/**
+ * @brief A parsed routing query.
+ */
+struct RouteQuery {
+    string mode = "driving";
+    int source = 0;
+    int destination = 0;
+    vector<int> avoidNodes;
+    vector<pair<int, int>> avoidSegments;
+    int includeNode = 0;   ///< 0 if no node has to be included (IDs start at 1)
+    int timeLimitMs = 0;   ///< search time limit in milliseconds, 0 if there is none
+    int line = 0;          ///< line where the record starts
+
+    /**
+     * @brief Whether the query has any restriction (restricted route instead of best + alternative).
+     */
+    bool isRestricted() const {
+        return !avoidNodes.empty() || !avoidSegments.empty() || includeNode != 0;
+    }
+
+    void clear() {
+        mode = "driving";
+        source = destination = includeNode = timeLimitMs = line = 0;
+        avoidNodes.clear();
+        avoidSegments.clear();
+    }
+};
+
+/**
+ * @brief Outcome of QueryParser::next.
+ */
+enum ParseStatus {
+    PARSE_OK,     ///< a valid query was read
+    PARSE_ERROR,  ///< a malformed record was skipped; see error()
+    PARSE_END     ///< no more input
+};
+
+/**
+ * @brief Streaming parser of keyed query records.
+ */
+class QueryParser {
+public:
+    /**
+     * @param in Input stream.
+     * @param g Graph used to validate node IDs; nullptr disables validation.
+     * @param resolver Resolves locations that are not numeric IDs; nullptr accepts IDs only.
+     */
+    QueryParser(istream & in, const Graph<int> * g = nullptr, const LocationResolver * resolver = nullptr);
+
+    ParseStatus next(RouteQuery & q);
+    const string & error() const;
+
+private:
+    istream & in;
+    const LocationResolver * resolver;
+    vector<int> ids;   ///< sorted valid node IDs
+    bool checkIds;
+    string lineBuf;
+    bool pending = false; ///< lineBuf holds the first line of the next record
+    int lineNo = 0;
+    string err;
+
+    bool fail(int line, const string & msg);
+};
+
+/**
+ * @brief Sorted IDs of the vertices of a graph, used to validate queries.
+ * @complexity O(V log V).
+ */
+inline vector<int> sortedVertexIds(const Graph<int> & g) {
+    vector<int> ids;
+    for (auto v : g.getVertexSet()) ids.push_back(v->getInfo());
+    sort(ids.begin(), ids.end());
+    return ids;
+}
+
+/**
+ * @brief Checks the semantic constraints of a query.
+ * @details Source and destination are required, the mode must be "driving", and every
+ * node ID (source, destination, include node, avoid lists) must be in ids.
+ *
+ * @param q Query to check.
+ * @param ids Sorted valid node IDs (see sortedVertexIds).
+ * @param err Receives a description of the problem on failure.
+ * @return True if the query is valid.
+ * @complexity O(K log V), where K is the number of IDs in the query.
+ */
+inline bool validateQuery(const RouteQuery & q, const vector<int> & ids, string & err) {
+    auto known = [&ids](int id) { return binary_search(ids.begin(), ids.end(), id); };
+    if (q.source == 0) err = "missing Source";
+    else if (q.destination == 0) err = "missing Destination";
+    else if (q.mode != "driving") err = "unsupported Mode '" + q.mode + "' (expected 'driving')";
+    else if (!known(q.source)) err = "unknown Source node " + to_string(q.source);
+    else if (!known(q.destination)) err = "unknown Destination node " + to_string(q.destination);
+    else if (q.includeNode != 0 && !known(q.includeNode)) err = "unknown IncludeNode " + to_string(q.includeNode);
+    else {
+        for (int id : q.avoidNodes) {
+            if (!known(id)) {
+                err = "unknown node " + to_string(id) + " in AvoidNodes";
+                return false;
+            }
+        }
+        for (auto & s : q.avoidSegments) {
+            if (!known(s.first) || !known(s.second)) {
+                err = "unknown node in AvoidSegments (" + to_string(s.first) + "," + to_string(s.second) + ")";
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Case-insensitive comparison of a character range with a lowercase key.
+ */
+inline bool keyEquals(const char * b, const char * e, const char * key) {
+    for (; b < e && *key; b++, key++) {
+        char c = *b;
+        if (c >= 'A' && c <= 'Z') c = c - 'A' + 'a';
+        if (c != *key) return false;
+    }
+    return b == e && *key == 0;
+}
+
+/**
+ * @brief Trims spaces, tabs and line terminators from both ends of a range.
+ */
+inline void trimRange(const char *& b, const char *& e) {
+    while (b < e && (*b == ' ' || *b == '\t' || *b == '\r' || *b == '\n')) b++;
+    while (e > b && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r' || e[-1] == '\n')) e--;
+}
+
+/**
+ * @brief Parses a whole range as a single integer.
+ */
+inline bool parseWholeInt(const char * b, const char * e, int & value) {
+    trimRange(b, e);
+    return parseInt(b, e, value) && b == e;
+}
+
+/**
+ * @brief Parses a location: a node ID or, with a resolver, anything it resolves.
+ * @param why Receives the resolver's reason on failure (empty for a plain bad ID).
+ */
+inline bool parseLocation(const char * b, const char * e, const LocationResolver * resolver, int & id, string & why) {
+    why.clear();
+    if (parseWholeInt(b, e, id)) return true;
+    return resolver != nullptr && resolver->resolve(string(b, e), id, why);
+}
+
+/**
+ * @brief Parses a comma-separated list of locations, appending their IDs to out.
+ */
+inline bool parseLocationList(const char * b, const char * e, const LocationResolver * resolver,
+                              vector<int> & out, string & why) {
+    why.clear();
+    size_t start = out.size();
+    if (parseAvoidNodes(b, e, out)) return true;
+    out.resize(start);
+    if (resolver == nullptr) return false;
+    while (b < e) {
+        const char * c = b;
+        while (c < e && *c != ',') c++;
+        int id;
+        if (!resolver->resolve(string(b, c), id, why)) return false;
+        out.push_back(id);
+        b = c < e ? c + 1 : e;
+    }
+    return true;
+}
+
+/**
+ * @brief Parses a list of "(location,location)" segments, appending them to out.
+ */
+inline bool parseSegmentList(const char * b, const char * e, const LocationResolver * resolver,
+                             vector<pair<int, int>> & out, string & why) {
+    why.clear();
+    size_t start = out.size();
+    if (parseAvoidSegments(b, e, out)) return true;
+    out.resize(start);
+    if (resolver == nullptr) return false;
+    while (true) {
+        while (b < e && (*b == ' ' || *b == '\t' || *b == ',')) b++;
+        if (b == e) return true;
+        if (*b != '(') return false;
+        const char * comma = b + 1, * close;
+        while (comma < e && *comma != ',') comma++;
+        for (close = comma; close < e && *close != ')'; close++) {}
+        if (close == e) return false;
+        int id1, id2;
+        if (!parseLocation(b + 1, comma, resolver, id1, why) || !parseLocation(comma + 1, close, resolver, id2, why)) {
+            return false;
+        }
+        out.push_back({id1, id2});
+        b = close + 1;
+    }
+}
+
+inline QueryParser::QueryParser(istream & in, const Graph<int> * g, const LocationResolver * resolver)
+    : in(in), resolver(resolver), checkIds(g != nullptr) {
+    if (g != nullptr) ids = sortedVertexIds(*g);
+}
+
+inline const string & QueryParser::error() const {
+    return err;
+}
+
+inline bool QueryParser::fail(int line, const string & msg) {
+    err = "line " + to_string(line) + ": " + msg;
+    return false;
+}
+
+/**
+ * @brief Reads the next query record.
+ * @param q Receives the query (its buffers are reused).
+ * @return PARSE_OK, PARSE_ERROR (the record was skipped) or PARSE_END.
+ * @complexity O(L + K log V), for L characters in the record.
+ */
+inline ParseStatus QueryParser::next(RouteQuery & q) {
+    MemoryScope scope(MEM_PARSER);
+    q.clear();
+    bool any = false, bad = false;
+    unsigned seen = 0; // bit per key already set in this record
+
+    while (pending || getline(in, lineBuf)) {
+        if (!pending) lineNo++;
+        pending = false;
+        const char * b = lineBuf.data();
+        const char * e = b + lineBuf.size();
+        trimRange(b, e);
+
+        if (b == e || (e - b == 3 && b[0] == '-' && b[1] == '-' && b[2] == '-')) {
+            if (any) break;
+            continue;
+        }
+        if (!any) q.line = lineNo;
+
+        const char * colon = b;
+        while (colon < e && *colon != ':') colon++;
+        if (colon == e) {
+            if (!bad) fail(lineNo, "expected 'Key:value'");
+            bad = true;
+            any = true;
+            continue;
+        }
+        const char * kb = b, * ke = colon;
+        trimRange(kb, ke);
+        const char * vb = colon + 1, * ve = e;
+        trimRange(vb, ve);
+
+        unsigned bit;
+        if (keyEquals(kb, ke, "mode")) bit = 1;
+        else if (keyEquals(kb, ke, "source")) bit = 2;
+        else if (keyEquals(kb, ke, "destination")) bit = 4;
+        else if (keyEquals(kb, ke, "avoidnodes")) bit = 8;
+        else if (keyEquals(kb, ke, "avoidsegments")) bit = 16;
+        else if (keyEquals(kb, ke, "includenode") || keyEquals(kb, ke, "includenodes")) bit = 32;
+        else if (keyEquals(kb, ke, "timelimit")) bit = 64;
+        else {
+            if (!bad) fail(lineNo, "unknown key '" + string(kb, ke) + "'");
+            bad = true;
+            any = true;
+            continue;
+        }
+
+        if (seen & bit) { // a repeated key starts the next record
+            pending = true;
+            break;
+        }
+        seen |= bit;
+        any = true;
+        if (bad) continue;
+
+        bool ok = true;
+        string why;
+        switch (bit) {
+            case 1: q.mode.assign(vb, ve); break;
+            case 2: ok = parseLocation(vb, ve, resolver, q.source, why); break;
+            case 4: ok = parseLocation(vb, ve, resolver, q.destination, why); break;
+            case 8: ok = parseLocationList(vb, ve, resolver, q.avoidNodes, why); break;
+            case 16: ok = parseSegmentList(vb, ve, resolver, q.avoidSegments, why); break;
+            case 32: ok = vb == ve || parseLocation(vb, ve, resolver, q.includeNode, why); break;
+            case 64: ok = parseWholeInt(vb, ve, q.timeLimitMs) && q.timeLimitMs >= 0; break;
+        }
+        if (!ok) {
+            fail(lineNo, "invalid value for '" + string(kb, ke) + "': " + (why.empty() ? "'" + string(vb, ve) + "'" : why));
+            bad = true;
+        }
+    }
+
+    if (!any) return PARSE_END;
+    if (bad) return PARSE_ERROR;
+    string msg;
+    if (checkIds ? !validateQuery(q, ids, msg) : (q.source == 0 || q.destination == 0)) {
+        fail(q.line, checkIds ? msg : "missing Source or Destination");
+        return PARSE_ERROR;
+    }
+    return PARSE_OK;
+}
+
+/**
+ * @brief Parses a command-line query.
+ * @details Format: "mode source destination avoidNodes avoidSegments includeNode",
+ * separated by whitespace, with '_' for empty restriction fields. With a resolver,
+ * locations may be codes or names without spaces, as in QueryParser.
+ *
+ * @param line Query line.
+ * @param q Receives the query.
+ * @param err Receives a description of the problem on failure.
+ * @param resolver Resolves locations that are not numeric IDs (may be nullptr).
+ * @return True if the line is a well-formed query.
+ * @complexity O(L), where L is the length of the line.
+ */
+inline bool parseCommandQuery(const string & line, RouteQuery & q, string & err,
+                              const LocationResolver * resolver = nullptr) {
+    MemoryScope scope(MEM_PARSER);
+    q.clear();
+    q.line = 1;
+    const char * p = line.data(), * end = p + line.size();
+    const char * tok[6][2];
+    int n = 0;
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+        if (p == end) break;
+        const char * s = p;
+        while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') p++;
+        if (n == 6) {
+            err = "too many fields (expected 6)";
+            return false;
+        }
+        tok[n][0] = s;
+        tok[n][1] = p;
+        n++;
+    }
+    if (n != 6) {
+        err = "expected 6 fields: mode source destination avoidNodes avoidSegments includeNode";
+        return false;
+    }
+    auto empty = [&](int i) { return tok[i][1] - tok[i][0] == 1 && *tok[i][0] == '_'; };
+
+    q.mode.assign(tok[0][0], tok[0][1]);
+    string why;
+    auto bad = [&](const char * field) {
+        err = string("invalid ") + field + (why.empty() ? "" : ": " + why);
+        return false;
+    };
+    if (!parseLocation(tok[1][0], tok[1][1], resolver, q.source, why)) return bad("source");
+    if (!parseLocation(tok[2][0], tok[2][1], resolver, q.destination, why)) return bad("destination");
+    if (!empty(3) && !parseLocationList(tok[3][0], tok[3][1], resolver, q.avoidNodes, why)) return bad("avoidNodes");
+    if (!empty(4) && !parseSegmentList(tok[4][0], tok[4][1], resolver, q.avoidSegments, why)) {
+        return bad("avoidSegments");
+    }
+    if (!empty(5) && !parseLocation(tok[5][0], tok[5][1], resolver, q.includeNode, why)) return bad("includeNode");
+    return true;
+}
+
+#endif //QUERYPARSER_H
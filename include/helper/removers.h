@@ -9,11 +9,104 @@
 #define REMOVERS_H
 
 #include <vector>
-#include <sstream>
+#include <string>
+#include <utility>
 
 #include "../data_structs/Graph.h"
 using namespace std;
 
+/**
+ * @brief Parses an integer from a character range.
+ * @details Skips leading whitespace and accepts an optional sign. Does not allocate.
+ *
+ * @param p Current position; advanced past the number on success.
+ * @param end End of the range.
+ * @param value Receives the parsed integer.
+ * @return True if a number that fits in an int was read, false otherwise.
+ * @complexity O(L), where L is the number of characters read.
+ */
+inline bool parseInt(const char*& p, const char* end, int& value) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+    if (p == end || *p < '0' || *p > '9') return false;
+    long long v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + (*p++ - '0');
+        if (v > 2147483647LL) return false;
+    }
+    value = (int) (neg ? -v : v);
+    return true;
+}
+
+/**
+ * @brief Parses a list of nodes to avoid, without allocating.
+ * @details Reads comma-separated node IDs, e.g. "3,7,12", appending them to out.
+ * Whitespace around the IDs is ignored; an empty range is an empty list.
+ *
+ * @param p Start of the range.
+ * @param end End of the range.
+ * @param out Receives the node IDs (reusing its capacity).
+ * @return True if the whole range is a valid list, false otherwise.
+ * @complexity O(L), where L is the length of the range.
+ */
+inline bool parseAvoidNodes(const char* p, const char* end, vector<int>& out) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    while (p < end) {
+        int id;
+        if (!parseInt(p, end, id)) return false;
+        out.push_back(id);
+        while (p < end && (*p == ' ' || *p == '\t')) p++;
+        if (p < end && *p++ != ',') return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Parses a list of segments to avoid, without allocating.
+ * @details Reads edge pairs in the format "(id1,id2),(id3,id4)", appending them to out.
+ * Whitespace is ignored and the comma between pairs is optional.
+ *
+ * @param p Start of the range.
+ * @param end End of the range.
+ * @param out Receives the (origin, destination) pairs (reusing its capacity).
+ * @return True if the whole range is a valid list, false otherwise.
+ * @complexity O(L), where L is the length of the range.
+ */
+inline bool parseAvoidSegments(const char* p, const char* end, vector<pair<int, int>>& out) {
+    while (true) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == ',')) p++;
+        if (p == end) return true;
+        int id1, id2;
+        if (*p++ != '(' || !parseInt(p, end, id1)) return false;
+        while (p < end && (*p == ' ' || *p == '\t')) p++;
+        if (p == end || *p++ != ',' || !parseInt(p, end, id2)) return false;
+        while (p < end && (*p == ' ' || *p == '\t')) p++;
+        if (p == end || *p++ != ')') return false;
+        out.push_back({id1, id2});
+    }
+}
+
+/**
+ * @brief Parses a list of nodes to avoid.
+ * @details Reads a comma-separated string of node IDs, e.g. "3,7,12".
+ *
+ * @param nodes String containing node IDs separated by commas.
+ * @return vector<int> with the parsed node IDs, in input order (empty if malformed).
+ * @complexity O(L), where L is the length of the string.
+ */
+vector<int> parseAvoidNodes(const string& nodes);
+
+/**
+ * @brief Parses a list of segments to avoid.
+ * @details Reads a string of edge pairs in the format "(id1,id2),(id3,id4)".
+ *
+ * @param Segments String containing edge pairs, formatted as "(id1,id2)".
+ * @return vector of (origin, destination) pairs, in input order (empty if malformed).
+ * @complexity O(L), where L is the length of the string.
+ */
+vector<pair<int, int>> parseAvoidSegments(const string& Segments);
+
 /**
  * @brief Removes a path from the graph.
  * @details Iterates through the given path and removes edges between consecutive nodes.
@@ -23,88 +116,46 @@ using namespace std;
  * @param path Vector containing the sequence of nodes in the path.
  * @complexity O(V + E), where V is the number of nodes in the path and E is the number of edges checked.
  */
-void removePath(Graph<int>* g, const std::vector<int>& path) {
-    for (int i = 1; i < path.size() - 1; i++) {
-        int from = path[i];
-        int to = path[i + 1];
+void removePath(Graph<int>* g, const std::vector<int>& path);
 
-        Vertex<int>* v = g->findVertex(from);
-        if (v != nullptr) {
-            for (auto& adj : v->getAdj()) {
-                if (adj->getDest()->getInfo() == to) {
-                    v->removeEdge(to);
-                    break;
-                }
-            }
-        }
-    }
-    for (int i = 1; i < path.size() - 1; i++) {
-        g->removeVertex(path[i]);
-    }
-} //alterRouting
+/**
+ * @brief Removes specified nodes from the graph.
+ * @details Removes every listed node and all of its incoming and outgoing edges.
+ *
+ * @param g Pointer to the graph.
+ * @param avoidNodes IDs of the nodes to remove.
+ * @complexity O(K (V + E)), where K is the number of nodes to remove.
+ */
+void remNodes(Graph<int>* g, const vector<int>& avoidNodes);
 
 /**
  * @brief Removes specified nodes from the graph.
- * @details Parses a comma-separated string of node IDs, removes their edges, then deletes the nodes.
+ * @details Parses a comma-separated string of node IDs and removes them with remNodes.
  *
  * @param g Pointer to the graph.
  * @param nodes String containing node IDs to be removed, separated by commas.
- * @complexity O(V + E), where V is the number of nodes to remove and E is the number of edges connected to them.
+ * @complexity O(K (V + E)), where K is the number of nodes to remove.
  */
-void remNode(Graph<int>* g, string nodes) {
-    vector<int> avoidNodes;
-    istringstream iss(nodes);
-    string node;
-    while (getline(iss, node, ',')) {
-        avoidNodes.push_back(stoi(node));
-    }
+void remNode(Graph<int>* g, string nodes);
 
-    for (int i = 0; i < avoidNodes.size() - 1; i++) {
-        Vertex<int>* v = g->findVertex(avoidNodes[i]);
-        if (v != nullptr) {
-            for (auto& adj : v->getAdj()) {
-                v->removeEdge(adj->getDest()->getInfo());
-            }
-        }
-        g->removeVertex(avoidNodes[i]);
-    }
-} //avoidNode
+/**
+ * @brief Removes specified edges from the graph.
+ * @details Removes every edge going from the first to the second node of each pair.
+ *
+ * @param g Pointer to the graph.
+ * @param avoidSegments (origin, destination) pairs of the edges to remove.
+ * @complexity O(K (V + d)), where K is the number of segments and d the degree of their origins.
+ */
+void remEdges(Graph<int>* g, const vector<pair<int, int>>& avoidSegments);
 
 /**
  * @brief Removes specified edges from the graph.
- * @details Parses a string of edge pairs in the format "(id1,id2)", removes corresponding edges.
+ * @details Parses a string of edge pairs in the format "(id1,id2)" and removes them with remEdges.
  *
  * @param g Pointer to the graph.
  * @param Segments String containing edge pairs to be removed, formatted as "(id1,id2)".
- * @complexity O(E), where E is the number of edges checked for removal.
+ * @complexity O(K (V + d)), where K is the number of segments and d the degree of their origins.
  */
-void remEdge(Graph<int>* g, string Segments) {
-    vector<int> avoidSegments;
-    istringstream ss(Segments);
-    char ignore; // For characters like '(', ')', and ','
-    int id1, id2;
-
-    while (ss >> ignore >> id1 >> ignore >> id2 >> ignore) {
-        avoidSegments.push_back(id1);
-        avoidSegments.push_back(id2);
-    }
-
-    int i = 0;
-    int j = 1;
-
-    while (i != avoidSegments.size() && j != avoidSegments.size()) {
-        Vertex<int>* v = g->findVertex(avoidSegments[i]);
-        if (v != nullptr) {
-            for (auto& adj : v->getAdj()) {
-                if (adj->getDest()->getInfo() == avoidSegments[j]) {
-                    v->removeEdge(avoidSegments[j]);
-                    break;
-                }
-            }
-        }
-        i+=2;
-        j+=2;
-    }
-} //avoidSegment
+void remEdge(Graph<int>* g, string Segments);
 
 #endif //REMOVERS_H
@@ -0,0 +1,276 @@
+/**
+ * @file reorder.h
+ * @brief Vertex reordering for memory locality.
+ * @details The vertices are stored in the order of Locations.csv, which has nothing
+ * to do with the graph topology. These functions compute a better order (BFS,
+ * reverse Cuthill-McKee or a Hilbert curve over coordinates) and apply it with
+ * Graph::reorderVertices, so that vertices which are close in the graph are also
+ * close in memory. Vertex IDs (and therefore getPath output) are not changed;
+ * VertexOrder keeps the map between internal slots and external location IDs.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef REORDER_H
+#define REORDER_H
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include "../data_structs/Graph.h"
+using namespace std;
+
+/**
+ * @brief Available vertex orderings.
+ */
+enum OrderingMethod {
+    ORDER_NONE,     ///< keep the Locations.csv order
+    ORDER_BFS,      ///< breadth-first order
+    ORDER_RCM,      ///< reverse Cuthill-McKee
+    ORDER_HILBERT   ///< Hilbert curve over the coordinates (BFS if there are none)
+};
+
+/**
+ * @brief Bidirectional map between internal vertex slots and external location IDs.
+ */
+template <class T>
+struct VertexOrder {
+    vector<T> slotToId;            ///< slot -> location ID
+    unordered_map<T, int> idToSlot; ///< location ID -> slot
+
+    int slot(const T &id) const {
+        auto it = idToSlot.find(id);
+        return it == idToSlot.end() ? -1 : it->second;
+    }
+};
+
+/**
+ * @brief Builds the slot/ID map of a graph in its current order.
+ * @complexity O(V).
+ */
+template <class T>
+VertexOrder<T> vertexOrderOf(const Graph<T> &g) {
+    VertexOrder<T> res;
+    for (auto v : g.getVertexSet()) {
+        res.idToSlot[v->getInfo()] = res.slotToId.size();
+        res.slotToId.push_back(v->getInfo());
+    }
+    return res;
+}
+
+/**
+ * @brief Builds the undirected neighbourhood of every slot.
+ * @details Directions are ignored for ordering purposes, since a search on either
+ * endpoint of an edge touches the other.
+ * @complexity O(V + E log E).
+ */
+template <class T>
+vector<vector<int>> undirectedNeighbours(const Graph<T> &g) {
+    auto vs = g.getVertexSet();
+    unordered_map<Vertex<T> *, int> slot;
+    for (unsigned i = 0; i < vs.size(); i++) slot[vs[i]] = i;
+
+    vector<vector<int>> nb(vs.size());
+    for (unsigned i = 0; i < vs.size(); i++) {
+        for (auto e : vs[i]->getAdj()) {
+            int j = slot[e->getDest()];
+            if (j == (int) i) continue;
+            nb[i].push_back(j);
+            nb[j].push_back(i);
+        }
+    }
+    for (auto &l : nb) {
+        sort(l.begin(), l.end());
+        l.erase(unique(l.begin(), l.end()), l.end());
+    }
+    return nb;
+}
+
+/**
+ * @brief Cuthill-McKee style traversal shared by BFS and RCM.
+ * @details Each connected component is started at its minimum-degree vertex.
+ * When byDegree is set, neighbours are visited by increasing degree (Cuthill-McKee).
+ * @complexity O(V + E log E).
+ */
+inline vector<int> traversalOrder(const vector<vector<int>> &nb, bool byDegree) {
+    int n = nb.size();
+    vector<int> starts(n);
+    for (int i = 0; i < n; i++) starts[i] = i;
+    stable_sort(starts.begin(), starts.end(),
+                [&nb](int a, int b) { return nb[a].size() < nb[b].size(); });
+
+    vector<int> order;
+    order.reserve(n);
+    vector<bool> seen(n, false);
+    vector<int> next;
+    for (int s : starts) {
+        if (seen[s]) continue;
+        seen[s] = true;
+        unsigned head = order.size();
+        order.push_back(s);
+        while (head < order.size()) {
+            int u = order[head++];
+            next.clear();
+            for (int v : nb[u])
+                if (!seen[v]) next.push_back(v);
+            if (byDegree)
+                stable_sort(next.begin(), next.end(),
+                            [&nb](int a, int b) { return nb[a].size() < nb[b].size(); });
+            for (int v : next) {
+                seen[v] = true;
+                order.push_back(v);
+            }
+        }
+    }
+    return order;
+}
+
+/**
+ * @brief Breadth-first vertex order.
+ * @return order[k] = current slot of the vertex placed at slot k.
+ * @complexity O(V + E log E).
+ */
+template <class T>
+vector<int> bfsOrder(const Graph<T> &g) {
+    return traversalOrder(undirectedNeighbours(g), false);
+}
+
+/**
+ * @brief Reverse Cuthill-McKee vertex order.
+ * @return order[k] = current slot of the vertex placed at slot k.
+ * @complexity O(V + E log E).
+ */
+template <class T>
+vector<int> rcmOrder(const Graph<T> &g) {
+    vector<int> order = traversalOrder(undirectedNeighbours(g), true);
+    reverse(order.begin(), order.end());
+    return order;
+}
+
+/**
+ * @brief Position of a point along a Hilbert curve over a 2^16 x 2^16 grid.
+ * @complexity O(1).
+ */
+inline unsigned long long hilbertIndex(unsigned x, unsigned y) {
+    const unsigned n = 1u << 16;
+    unsigned long long d = 0;
+    for (unsigned s = n / 2; s > 0; s /= 2) {
+        unsigned rx = (x & s) > 0;
+        unsigned ry = (y & s) > 0;
+        d += (unsigned long long) s * s * ((3 * rx) ^ ry);
+        if (ry == 0) { // rotate the quadrant
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            swap(x, y);
+        }
+    }
+    return d;
+}
+
+/**
+ * @brief Hilbert curve vertex order.
+ * @details Vertices without coordinates are placed after the others, in BFS order.
+ * If no vertex has coordinates, this is the BFS order.
+ *
+ * @param g Graph to order.
+ * @param coords Map of location ID to (x, y) coordinates, e.g. (longitude, latitude).
+ * @return order[k] = current slot of the vertex placed at slot k.
+ * @complexity O(V log V + E log E).
+ */
+template <class T>
+vector<int> hilbertOrder(const Graph<T> &g, const unordered_map<T, pair<double, double>> &coords) {
+    vector<int> bfs = bfsOrder(g);
+    if (coords.empty()) return bfs;
+
+    auto vs = g.getVertexSet();
+    double minX = INF, minY = INF, maxX = -INF, maxY = -INF;
+    for (auto &c : coords) {
+        minX = min(minX, c.second.first);  maxX = max(maxX, c.second.first);
+        minY = min(minY, c.second.second); maxY = max(maxY, c.second.second);
+    }
+    double spanX = max(maxX - minX, 1e-12), spanY = max(maxY - minY, 1e-12);
+
+    vector<pair<unsigned long long, int>> keyed; // (hilbert index, slot)
+    vector<int> rest;
+    for (int s : bfs) {
+        auto it = coords.find(vs[s]->getInfo());
+        if (it == coords.end()) {
+            rest.push_back(s);
+            continue;
+        }
+        unsigned x = (unsigned) ((it->second.first - minX) / spanX * 65535.0);
+        unsigned y = (unsigned) ((it->second.second - minY) / spanY * 65535.0);
+        keyed.push_back({hilbertIndex(x, y), s});
+    }
+    stable_sort(keyed.begin(), keyed.end(),
+                [](const pair<unsigned long long, int> &a, const pair<unsigned long long, int> &b) {
+                    return a.first < b.first;
+                });
+    vector<int> order;
+    order.reserve(vs.size());
+    for (auto &k : keyed) order.push_back(k.second);
+    order.insert(order.end(), rest.begin(), rest.end());
+    return order;
+}
+
+/**
+ * @brief Computes an order with the given method.
+ * @return order[k] = current slot of the vertex placed at slot k.
+ */
+template <class T>
+vector<int> computeOrder(const Graph<T> &g, OrderingMethod method,
+                         const unordered_map<T, pair<double, double>> &coords = unordered_map<T, pair<double, double>>()) {
+    switch (method) {
+        case ORDER_BFS: return bfsOrder(g);
+        case ORDER_RCM: return rcmOrder(g);
+        case ORDER_HILBERT: return hilbertOrder(g, coords);
+        default: break;
+    }
+    vector<int> order(g.getNumVertex());
+    for (unsigned i = 0; i < order.size(); i++) order[i] = i;
+    return order;
+}
+
+/**
+ * @brief Reorders the driving and walking graphs after loadGraphs.
+ * @details The order is computed on the driving graph and applied to both graphs,
+ * so a slot refers to the same location in either one. Both graphs must contain
+ * the same vertices in the same order, which is how loadLocations builds them;
+ * otherwise neither graph is changed.
+ *
+ * @param drive Graph containing the driving distances.
+ * @param walk Graph containing the walking distances.
+ * @param method Ordering to apply.
+ * @param order Filled with the VertexOrder mapping the slots to location IDs (the
+ * current slots if the graphs were not reordered).
+ * @param coords Optional location coordinates, used by ORDER_HILBERT.
+ * @return False if the graphs do not have the same vertices in the same order or
+ * could not be reordered.
+ * @complexity O(V log V + E log E).
+ */
+template <class T>
+bool reorderGraphs(Graph<T> &drive, Graph<T> &walk, OrderingMethod method, VertexOrder<T> &order,
+                   const unordered_map<T, pair<double, double>> &coords = unordered_map<T, pair<double, double>>()) {
+    const auto &dv = drive.getVertexSet(), &wv = walk.getVertexSet();
+    bool same = dv.size() == wv.size();
+    for (size_t i = 0; same && i < dv.size(); i++) same = dv[i]->getInfo() == wv[i]->getInfo();
+
+    if (same && method != ORDER_NONE) {
+        vector<int> newOrder = computeOrder(drive, method, coords);
+        same = drive.reorderVertices(newOrder);
+        if (same && !walk.reorderVertices(newOrder)) {
+            vector<int> inverse(newOrder.size()); // put the driving graph back
+            for (unsigned k = 0; k < newOrder.size(); k++) inverse[newOrder[k]] = k;
+            drive.reorderVertices(inverse);
+            same = false;
+        }
+    }
+    order = vertexOrderOf(drive);
+    return same;
+}
+
+#endif //REORDER_H
@@ -0,0 +1,230 @@
+/**
+ * @file replacementPaths.h
+ * @brief Best detour for the removal of each segment of a shortest route.
+ * @details Given the best route s = v0, v1, ..., vk = t, the detour that avoids
+ * segment vi->vi+1 is wanted for every i. Running remEdge and dijkstra k times costs
+ * k searches and mutates the graph; here the whole table comes from two trees:
+ *
+ * - a forward shortest-path tree from s, in which the route is a branch;
+ * - a backward shortest-path tree to t, forced to use the route as a branch too.
+ *
+ * Let f(u) be the index where the tree path s->u leaves the route, and b(w) the index
+ * where the tree path w->t joins it. Any other edge u->w gives the walk s->u->w->t of
+ * length ds(u) + w(u, w) + dt(w), which uses route segments 0..f(u)-1 and b(w)..k-1
+ * only, so it is a valid detour for every segment i with f(u) <= i < b(w). A sweep
+ * over these intervals keeps the cheapest candidate of each segment.
+ *
+ * The candidates are exact on undirected (symmetric) networks. On directed ones a
+ * detour may need to leave the trees more than once, so the candidate is only an upper
+ * bound. The two trees are therefore only used when the caller states that the graph
+ * is symmetric (isSymmetric checks it); otherwise one search is run per segment, still
+ * without touching the graph. Segments are avoided as remEdge does: every parallel
+ * edge vi->vi+1 is excluded.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef REPLACEMENTPATHS_H
+#define REPLACEMENTPATHS_H
+
+#include <vector>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include "../data_structs/CSRGraph.h"
+#include "csrDijkstra.h"
+using namespace std;
+
+/**
+ * @brief Best route that avoids one segment of the original route.
+ */
+struct Detour {
+    int from = 0, to = 0;  ///< vertex IDs of the avoided segment
+    int weight = INT_INF;  ///< weight of the detour route (INT_INF if there is none)
+    vector<int> path;      ///< vertex IDs of the detour route, empty if there is none
+};
+
+/**
+ * @brief Best route and the detour for each of its segments.
+ */
+struct ReplacementTable {
+    vector<int> route;      ///< vertex IDs of the best route, empty if t is unreachable
+    int weight = INT_INF;   ///< weight of the best route
+    vector<Detour> detours; ///< detours[i] avoids route[i] -> route[i+1]
+};
+
+/**
+ * @brief Shortest paths from a source slot that never use an edge from slot a to slot b.
+ * @complexity O((V + E) log V).
+ */
+inline void dijkstraAvoiding(const CSRGraph<int> &g, int source, int a, int b, ShortestPathTree &tree) {
+    int n = g.getNumVertex();
+    tree.dist.assign(n, INT_INF);
+    tree.parent.assign(n, -1);
+    typedef pair<int, int> Entry; // (distance, slot)
+    priority_queue<Entry, vector<Entry>, greater<Entry>> q;
+    tree.dist[source] = 0;
+    q.push({0, source});
+    while (!q.empty()) {
+        Entry top = q.top();
+        q.pop();
+        int u = top.second;
+        if (top.first != tree.dist[u]) continue; // stale entry
+        for (int e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+            int v = g.getTarget(e);
+            if (u == a && v == b) continue;
+            if (top.first + g.getWeight(e) < tree.dist[v]) {
+                tree.dist[v] = top.first + g.getWeight(e);
+                tree.parent[v] = e;
+                q.push({tree.dist[v], v});
+            }
+        }
+    }
+}
+
+/**
+ * @brief For every slot, the route index where following step[] first reaches the route.
+ * @details step[v] is the next slot from v (its tree parent, or its next hop to t) and
+ * pos[v] the index of v in the route (-1 if not on it). Slots whose chain never
+ * reaches the route get -1.
+ * @complexity O(V).
+ */
+inline vector<int> routeAnchors(const vector<int> &step, const vector<int> &pos) {
+    int n = step.size();
+    vector<int> anchor(n, -2), stack; // -2 = not computed yet
+    for (int v = 0; v < n; v++) {
+        int x = v;
+        while (anchor[x] == -2 && pos[x] == -1 && step[x] != -1) {
+            stack.push_back(x);
+            anchor[x] = -3; // in progress
+            x = step[x];
+        }
+        int a = pos[x] != -1 ? pos[x] : (anchor[x] >= -1 ? anchor[x] : -1);
+        anchor[x] = a;
+        while (!stack.empty()) {
+            anchor[stack.back()] = a;
+            stack.pop_back();
+        }
+    }
+    return anchor;
+}
+
+/**
+ * @brief Checks whether every edge u->v of weight w has a matching edge v->u of weight w.
+ * @complexity O(E log E).
+ */
+inline bool isSymmetric(const CSRGraph<int> &g) {
+    vector<tuple<int, int, int>> fwd, bwd;
+    for (int u = 0; u < g.getNumVertex(); u++) {
+        for (int e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+            fwd.push_back(make_tuple(u, g.getTarget(e), g.getWeight(e)));
+            bwd.push_back(make_tuple(g.getTarget(e), u, g.getWeight(e)));
+        }
+    }
+    sort(fwd.begin(), fwd.end());
+    sort(bwd.begin(), bwd.end());
+    return fwd == bwd;
+}
+
+/**
+ * @brief Computes the best route between two locations and the detour for each segment.
+ * @param g CSR graph.
+ * @param source Source vertex ID.
+ * @param destination Destination vertex ID.
+ * @param symmetric If true, the graph is symmetric and all the detours come from the
+ * two trees; otherwise each one is computed with its own search. Passing true for a
+ * directed graph gives upper bounds, not the best detours.
+ * @return The route and its detour table.
+ * @complexity O(k (V + E) log V); O((V + E) log V) plus O(E log E) for the sweep if
+ * symmetric.
+ */
+inline ReplacementTable replacementPaths(const CSRGraph<int> &g, int source, int destination, bool symmetric = false) {
+    ReplacementTable res;
+    int s = g.findSlot(source), t = g.findSlot(destination), n = g.getNumVertex();
+    if (s < 0 || t < 0) return res;
+
+    ShortestPathTree fwd;
+    csrDijkstra(g, s, fwd);
+    res.route = csrGetPath(g, fwd, t, res.weight);
+    if (res.route.empty()) {
+        res.weight = INT_INF;
+        return res;
+    }
+    int k = res.route.size() - 1;
+    vector<int> slots(k + 1), pos(n, -1);
+    for (int i = 0; i <= k; i++) {
+        slots[i] = g.findSlot(res.route[i]);
+        pos[slots[i]] = i;
+    }
+    res.detours.resize(k);
+    for (int i = 0; i < k; i++) {
+        res.detours[i].from = res.route[i];
+        res.detours[i].to = res.route[i + 1];
+    }
+
+    const vector<int> &off = g.getOffsets();
+    auto origin = [&](int e) { return (int) (upper_bound(off.begin(), off.end(), e) - off.begin() - 1); };
+
+    if (!symmetric) {
+        ShortestPathTree tree;
+        for (int i = 0; i < k; i++) {
+            dijkstraAvoiding(g, s, slots[i], slots[i + 1], tree);
+            res.detours[i].path = csrGetPath(g, tree, t, res.detours[i].weight);
+        }
+        return res;
+    }
+
+    // backward tree: dt(v) and the next slot towards t, with the route as a branch
+    vector<int> revIds;
+    CSRGraph<int> rev = g.reversed(&revIds);
+    ShortestPathTree bwd;
+    csrDijkstra(rev, t, bwd);
+    const vector<int> &revOff = rev.getOffsets();
+    vector<int> pred(n, -1), next(n, -1);
+    for (int v = 0; v < n; v++) {
+        if (fwd.parent[v] != -1) pred[v] = origin(fwd.parent[v]);
+        if (bwd.parent[v] != -1) next[v] = upper_bound(revOff.begin(), revOff.end(), bwd.parent[v]) - revOff.begin() - 1;
+    }
+    for (int i = 0; i < k; i++) next[slots[i]] = slots[i + 1];
+    next[t] = -1;
+
+    vector<int> f = routeAnchors(pred, pos), b = routeAnchors(next, pos);
+
+    // candidate intervals [f(u), b(w) - 1], swept by segment
+    typedef tuple<int, int, int, int> Candidate; // (first segment, last segment, cost, edge)
+    vector<Candidate> cand;
+    for (int u = 0; u < n; u++) {
+        if (fwd.dist[u] == INT_INF || f[u] < 0) continue;
+        for (int e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+            int w = g.getTarget(e);
+            if (bwd.dist[w] == INT_INF || b[w] < 0) continue;
+            if (pos[u] != -1 && pos[w] == pos[u] + 1) continue; // a route segment or a parallel edge of it
+            int first = f[u], last = b[w] - 1;
+            if (first > last) continue;
+            cand.push_back(make_tuple(first, last, fwd.dist[u] + g.getWeight(e) + bwd.dist[w], e));
+        }
+    }
+    sort(cand.begin(), cand.end());
+
+    typedef pair<int, size_t> Active; // (cost, candidate)
+    priority_queue<Active, vector<Active>, greater<Active>> active;
+    size_t c = 0;
+    for (int i = 0; i < k; i++) {
+        for (; c < cand.size() && get<0>(cand[c]) <= i; c++)
+            active.push({get<2>(cand[c]), c});
+        while (!active.empty() && get<1>(cand[active.top().second]) < i) active.pop();
+        if (active.empty()) continue;
+
+        Detour &d = res.detours[i];
+        int e = get<3>(cand[active.top().second]), u = origin(e), w = g.getTarget(e);
+        d.weight = active.top().first;
+        for (int v = u; v != -1; v = pred[v]) d.path.push_back(g.getInfo(v));
+        reverse(d.path.begin(), d.path.end());
+        for (int v = w; v != -1; v = next[v]) d.path.push_back(g.getInfo(v));
+    }
+    return res;
+}
+
+#endif //REPLACEMENTPATHS_H
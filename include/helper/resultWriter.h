@@ -0,0 +1,258 @@
+/**
+ * @file resultWriter.h
+ * @brief Buffered serialization of routing results.
+ * @details A single writer for every output of the program. Results are formatted
+ * into a pre-sized buffer, without iostreams, and written to a file descriptor in
+ * large blocks, so many results can be streamed to one descriptor (stdout, a file
+ * or a socket). Supported formats:
+ * - FORMAT_TEXT: the original "Source:/Destination:/...Route:" format.
+ * - FORMAT_NDJSON: one JSON object per result and line.
+ * - FORMAT_CSV: one row per route, with a header row.
+ * - FORMAT_BINARY: compact little-endian records for machine consumers.
+ *
+ * Binary layout: the stream starts with the magic "RTB2". Each result is
+ * int32 source, int32 destination, uint32 number of routes, and for each route
+ * uint8 label length, the label bytes, int32 weight (-1 if there is no route),
+ * uint32 path length and the int32 vertex IDs of the path.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef RESULTWRITER_H
+#define RESULTWRITER_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <unistd.h>
+using namespace std;
+
+/**
+ * @brief Output formats supported by ResultWriter.
+ */
+enum OutputFormat {
+    FORMAT_TEXT,
+    FORMAT_NDJSON,
+    FORMAT_CSV,
+    FORMAT_BINARY
+};
+
+/**
+ * @brief Parses an output format name ("text", "ndjson", "csv" or "binary").
+ * @param name Format name.
+ * @param format Receives the format.
+ * @return True if the name is valid, false otherwise.
+ * @complexity O(1).
+ */
+inline bool parseOutputFormat(const string & name, OutputFormat & format) {
+    if (name == "text") format = FORMAT_TEXT;
+    else if (name == "ndjson" || name == "json") format = FORMAT_NDJSON;
+    else if (name == "csv") format = FORMAT_CSV;
+    else if (name == "binary") format = FORMAT_BINARY;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Buffered writer of routing results.
+ * @details Usage: beginResult, one addRoute per route, endResult. The buffer is
+ * flushed when it fills up, on flush() and on destruction. The descriptor is not closed.
+ */
+class ResultWriter {
+public:
+    ResultWriter(int fd, OutputFormat format = FORMAT_TEXT, size_t bufferSize = 1 << 16);
+    ~ResultWriter();
+
+    void beginResult(int source, int destination);
+    void addRoute(const char * label, const vector<int> & path, int weight);
+    void endResult();
+
+    bool flush();
+    bool good() const;
+
+private:
+    int fd;
+    OutputFormat format;
+    size_t capacity;
+    string buf;
+    bool ok = true;
+    bool headerDone = false;
+    int source = 0, destination = 0;
+    unsigned routes = 0;
+    size_t countPos = 0; // position of the route count in the binary record
+
+    void reserveFor(size_t n);
+    void put(char c);
+    void put(const char * s, size_t n);
+    void put(const char * s);
+    void putInt(long long v);
+    void putRaw32(uint32_t v);
+};
+
+inline ResultWriter::ResultWriter(int fd, OutputFormat format, size_t bufferSize)
+    : fd(fd), format(format), capacity(bufferSize < 256 ? 256 : bufferSize) {
+    buf.reserve(capacity);
+}
+
+inline ResultWriter::~ResultWriter() {
+    flush();
+}
+
+/**
+ * @brief Writes the buffered bytes to the descriptor.
+ * @return False if a write failed (the writer then discards further output).
+ * @complexity O(B), for B buffered bytes.
+ */
+inline bool ResultWriter::flush() {
+    size_t done = 0;
+    while (ok && done < buf.size()) {
+        ssize_t n = ::write(fd, buf.data() + done, buf.size() - done);
+        if (n <= 0) ok = false;
+        else done += n;
+    }
+    buf.clear();
+    return ok;
+}
+
+inline bool ResultWriter::good() const {
+    return ok;
+}
+
+inline void ResultWriter::reserveFor(size_t n) {
+    if (buf.size() + n > capacity && format != FORMAT_BINARY) flush();
+}
+
+inline void ResultWriter::put(char c) {
+    buf.push_back(c);
+}
+
+inline void ResultWriter::put(const char * s, size_t n) {
+    buf.append(s, n);
+}
+
+inline void ResultWriter::put(const char * s) {
+    buf.append(s, strlen(s));
+}
+
+inline void ResultWriter::putInt(long long v) {
+    char tmp[24];
+    int i = sizeof(tmp);
+    bool neg = v < 0;
+    unsigned long long u = neg ? 0ULL - (unsigned long long) v : (unsigned long long) v;
+    do {
+        tmp[--i] = (char) ('0' + u % 10);
+        u /= 10;
+    } while (u);
+    if (neg) tmp[--i] = '-';
+    buf.append(tmp + i, sizeof(tmp) - i);
+}
+
+inline void ResultWriter::putRaw32(uint32_t v) {
+    char b[4] = {(char) (v & 0xff), (char) ((v >> 8) & 0xff), (char) ((v >> 16) & 0xff), (char) ((v >> 24) & 0xff)};
+    buf.append(b, 4);
+}
+
+/**
+ * @brief Starts a new result (one query).
+ * @complexity O(1) amortized.
+ */
+inline void ResultWriter::beginResult(int source, int destination) {
+    this->source = source;
+    this->destination = destination;
+    routes = 0;
+    if (buf.size() > capacity) flush();
+    switch (format) {
+        case FORMAT_TEXT:
+            put("Source:"); putInt(source); put('\n');
+            put("Destination:"); putInt(destination); put('\n');
+            break;
+        case FORMAT_NDJSON:
+            put("{\"source\":"); putInt(source);
+            put(",\"destination\":"); putInt(destination);
+            put(",\"routes\":[");
+            break;
+        case FORMAT_CSV:
+            if (!headerDone) put("source,destination,type,weight,path\n");
+            break;
+        case FORMAT_BINARY:
+            if (!headerDone) put("RTB2", 4);
+            putRaw32(source);
+            putRaw32(destination);
+            countPos = buf.size();
+            putRaw32(0); // route count, filled in by endResult
+            break;
+    }
+    headerDone = true;
+}
+
+/**
+ * @brief Adds a route to the current result.
+ * @param label Route type, e.g. "BestDrivingRoute".
+ * @param path Vertex IDs of the route; empty if there is none.
+ * @param weight Total weight of the route.
+ * @complexity O(P), where P is the number of vertices in the path.
+ */
+inline void ResultWriter::addRoute(const char * label, const vector<int> & path, int weight) {
+    reserveFor(path.size() * 12 + 64);
+    switch (format) {
+        case FORMAT_TEXT:
+            put(label); put(':');
+            if (path.empty()) {
+                put("none");
+            } else {
+                putInt(path[0]);
+                for (size_t i = 1; i < path.size(); i++) { put(','); putInt(path[i]); }
+                put('('); putInt(weight); put(')');
+            }
+            put('\n');
+            break;
+        case FORMAT_NDJSON:
+            if (routes) put(',');
+            put("{\"type\":\""); put(label); put("\",");
+            if (path.empty()) {
+                put("\"weight\":null,\"path\":null}");
+            } else {
+                put("\"weight\":"); putInt(weight); put(",\"path\":[");
+                for (size_t i = 0; i < path.size(); i++) { if (i) put(','); putInt(path[i]); }
+                put("]}");
+            }
+            break;
+        case FORMAT_CSV:
+            putInt(source); put(','); putInt(destination); put(','); put(label); put(',');
+            if (!path.empty()) {
+                putInt(weight); put(',');
+                for (size_t i = 0; i < path.size(); i++) { if (i) put(';'); putInt(path[i]); }
+            } else {
+                put(',');
+            }
+            put('\n');
+            break;
+        case FORMAT_BINARY: {
+            size_t len = strlen(label);
+            if (len > 255) len = 255;
+            put((char) len); put(label, len);
+            putRaw32(path.empty() ? (uint32_t) -1 : (uint32_t) weight);
+            putRaw32(path.size());
+            for (int v : path) putRaw32(v);
+            break;
+        }
+    }
+    routes++;
+}
+
+/**
+ * @brief Ends the current result.
+ * @complexity O(1) amortized.
+ */
+inline void ResultWriter::endResult() {
+    if (format == FORMAT_NDJSON) put("]}\n");
+    if (format == FORMAT_BINARY) {
+        for (int i = 0; i < 4; i++) buf[countPos + i] = (char) ((routes >> (8 * i)) & 0xff);
+        if (buf.size() >= capacity) flush();
+    } else if (buf.size() >= capacity) {
+        flush();
+    }
+}
+
+#endif //RESULTWRITER_H
@@ -14,12 +14,15 @@
 #include "../data_structs/Graph.h"
 #include "Dijkstra.h"
 #include "removers.h"
+#include "scc.h"
+#include "searchControl.h"
 using namespace std;
 
 /**
  * @brief Computes the best and the alternative routes between two points.
  * @details Uses Dijkstra's algorithm to find the shortest path, removes it,
- * and then finds an alternative path.
+ * and then finds an alternative path. If the component labels show that the destination
+ * cannot be reached, both routes are left empty without running Dijkstra.
  *
  * @param g1 Graph representation of the routes.
  * @param source Starting node.
@@ -28,78 +31,35 @@ using namespace std;
  * @param secPath Stores the secondary (alternative) route.
  * @param primaryW Stores the weight of the primary route.
  * @param alterW Stores the weight of the alternative route.
+ * @param control Deadline and cancellation of the request (nullptr for none).
+ * @return SEARCH_OK, SEARCH_PARTIAL if a route is best-effort (the alternative route is
+ * only searched after an exact best route), or the stop reason if no route was found.
  * @complexity O((V + E) log V) for Dijkstra’s execution twice.
  */
-void Routing(Graph<int> & g1, int source, int destination, std::vector<int> & primPath,
-                                std::vector<int> & secPath, int & primaryW, int & alterW){
-    dijkstra(&g1, source);
-    primPath = getPath(&g1, destination, primaryW);
-
-    if (primPath.empty()){
-        return;
-    }
-
-    removePath(&g1, primPath);
-    dijkstra(&g1, source);
-    secPath = getPath(&g1, destination, alterW);
-
-    if (alterW < primaryW && alterW != 0) {
-        cerr << "bad dijkstra handling-- alterWeight < primaryWeight" << endl;
-        exit(EXIT_FAILURE);
-    }
-}
+SearchStatus Routing(Graph<int> & g1, int source, int destination, std::vector<int> & primPath,
+                     std::vector<int> & secPath, int & primaryW, int & alterW, SearchControl * control = nullptr);
 
 /**
  * @brief Computes a restricted route based on node/edge restrictions.
  * @details Removes restricted nodes/edges and finds a route using Dijkstra's algorithm.
- * The boolean vector NSI indicates which restrictions apply, dependent on the user input.
  * If including a node, the function computes the shortest path to that node and then to the destination.
+ * Removals keep the component labels valid, so they still rule out impossible routes without a search.
  *
  * @param g1 Graph representation of the routes.
  * @param source Starting node.
  * @param destination Target node.
- * @param NSI Boolean vector indicating which restrictions apply.
- * @param N Node to avoid (if applicable).
- * @param S Edge to avoid (if applicable).
- * @param I Node that must be included in the path (if applicable).
+ * @param avoidNodes Nodes to avoid (may be empty).
+ * @param avoidSegments Segments (origin, destination) to avoid (may be empty).
+ * @param I Node that must be included in the path (0 if none).
  * @param path Stores the computed restricted route.
  * @param weight Stores the weight of the computed route.
+ * @param control Deadline and cancellation of the request (nullptr for none).
+ * @return SEARCH_OK, SEARCH_PARTIAL if the route is best-effort, or the stop reason if
+ * no route was found.
  * @complexity O((V + E) log V) for Dijkstra’s algorithm, possibly twice if including a node.
  */
-void avoidRouting(Graph<int>& g1, int source, int destination, std::vector<bool> NSI, string N,
-                                    string S, int I, std::vector<int> & path, int & weight) {
-    if (NSI[0] == true) {
-        remNode(&g1, N);
-    }
-    if (NSI[1] == true) {
-        remEdge(&g1, S);
-    }
-
-
-    if (NSI[2] == true) {
-        //shortest path to 'IncludeNode'
-        dijkstra(&g1, source);
-        int w1 = 0;
-        vector<int> primPath = getPath(&g1, I, w1);
-        if (primPath.empty()) {
-            return;
-        }
-        //shortest path from 'IncludeNode' to destination
-        dijkstra(&g1, I);
-        int w2 = 0;
-        vector<int> secPath = getPath(&g1, destination, w2);
-        if (secPath.empty()) {
-            return;
-        }
-        //
-        //appends------
-        //
-        path = primPath;
-        for (int i = 1; i < secPath.size(); i++) {
-            path.push_back(secPath[i]);
-        }
-        weight = w1 + w2;
-    }
-}
+SearchStatus avoidRouting(Graph<int>& g1, int source, int destination, const vector<int>& avoidNodes,
+                          const vector<pair<int, int>>& avoidSegments, int I, std::vector<int> & path, int & weight,
+                          SearchControl * control = nullptr);
 
 #endif //ROUTING_H
@@ -0,0 +1,138 @@
+/**
+ * @file scc.h
+ * @brief Strongly connected components, used as a reachability precheck.
+ * @details The edges of the graphs are directed and the 'X' cuts of Distances.csv
+ * leave parts of them unreachable from others. computeComponents labels every vertex
+ * with its strongly connected component (iterative Tarjan, so deep graphs cannot
+ * overflow the call stack) and its weakly connected component.
+ *
+ * Tarjan completes components in reverse topological order: if any edge leads from
+ * component A to a different component B, then B < A. Hence t can only be reachable
+ * from s if both lie in the same weak component and component(t) <= component(s).
+ * The test is O(1) and never rejects a reachable pair. Removing vertices or edges only
+ * makes fewer pairs reachable, so the labels stay valid (if less precise) afterwards.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef SCC_H
+#define SCC_H
+
+#include <vector>
+#include <algorithm>
+#include "../data_structs/Graph.h"
+using namespace std;
+
+/**
+ * @brief Labels every vertex with its strongly and weakly connected components.
+ * @details Uses the low/num/processing fields of the vertices; processing marks the
+ * vertices on the Tarjan stack. Strong component IDs are in reverse topological order
+ * of the condensation; weak component IDs are numbered from 0 in slot order.
+ *
+ * @tparam T Type of the graph vertices.
+ * @param g Pointer to the graph.
+ * @return Number of strongly connected components.
+ * @complexity O(V + E).
+ */
+template <class T>
+int computeComponents(Graph<T> *g) {
+    vector<Vertex<T> *> vertSet = g->getVertexSet();
+    int n = vertSet.size();
+    for (auto v : vertSet) {
+        v->setNum(-1);
+        v->setLow(-1);
+        v->setProcessing(false);
+    }
+
+    struct Frame {
+        Vertex<T> *v;
+        const vector<Edge<T> *> *adj; // the vertex's own list, not changed during the search
+        size_t next;
+    };
+    vector<Frame> calls;
+    vector<Vertex<T> *> stack, byNum(n);
+    int index = 0, comps = 0;
+
+    auto visit = [&](Vertex<T> *v) {
+        v->setNum(index);
+        v->setLow(index);
+        byNum[index++] = v;
+        v->setProcessing(true);
+        stack.push_back(v);
+        calls.push_back({v, &v->getAdj(), 0});
+    };
+
+    for (auto root : vertSet) {
+        if (root->getNum() != -1) continue;
+        visit(root);
+        while (!calls.empty()) {
+            Frame &f = calls.back();
+            if (f.next < f.adj->size()) {
+                Vertex<T> *w = (*f.adj)[f.next++]->getDest();
+                if (w->getNum() == -1) visit(w); // f is not used after this
+                else if (w->isProcessing()) f.v->setLow(min(f.v->getLow(), w->getNum()));
+                continue;
+            }
+            Vertex<T> *v = f.v;
+            calls.pop_back();
+            if (!calls.empty())
+                calls.back().v->setLow(min(calls.back().v->getLow(), v->getLow()));
+            if (v->getLow() == v->getNum()) {
+                Vertex<T> *w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    w->setProcessing(false);
+                    w->setComponent(comps);
+                } while (w != v);
+                comps++;
+            }
+        }
+    }
+
+    // weak components: union-find over the DFS numbers
+    vector<int> rep(n);
+    for (int i = 0; i < n; i++) rep[i] = i;
+    auto find = [&](int x) {
+        while (rep[x] != x) x = rep[x] = rep[rep[x]];
+        return x;
+    };
+    for (auto v : vertSet)
+        for (auto e : v->getAdj())
+            rep[find(v->getNum())] = find(e->getDest()->getNum());
+    vector<int> label(n, -1);
+    int weak = 0;
+    for (auto v : vertSet) {
+        int r = find(v->getNum());
+        if (label[r] == -1) label[r] = weak++;
+        v->setWeakComponent(label[r]);
+    }
+    return comps;
+}
+
+/**
+ * @brief Whether t may be reachable from s, according to the component labels.
+ * @details False means that there is certainly no path. Vertices without labels
+ * (computeComponents was not run) are assumed reachable. A bidirectional search may
+ * use it to skip vertices v with !mayReach(s, v) forwards or !mayReach(v, t) backwards.
+ * @complexity O(1).
+ */
+template <class T>
+bool mayReach(const Vertex<T> *s, const Vertex<T> *t) {
+    if (s->getComponent() == -1 || t->getComponent() == -1) return true;
+    return s->getWeakComponent() == t->getWeakComponent() && t->getComponent() <= s->getComponent();
+}
+
+/**
+ * @brief Whether the vertex with content dest may be reachable from the one with content source.
+ * @details False if either vertex does not exist (e.g. it was removed).
+ * @complexity O(V) to find the vertices, O(1) for the test itself.
+ */
+template <class T>
+bool mayReach(const Graph<T> *g, const T &source, const T &dest) {
+    Vertex<T> *s = g->findVertex(source), *t = g->findVertex(dest);
+    if (s == nullptr || t == nullptr) return false;
+    return mayReach(s, t);
+}
+
+#endif //SCC_H
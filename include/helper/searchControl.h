@@ -0,0 +1,145 @@
+/**
+ * @file searchControl.h
+ * @brief Deadlines and cancellation for the shortest-path searches.
+ * @details A SearchControl is passed to dijkstra, csrDijkstra, Routing and avoidRouting.
+ * The search loops call tick() once per heap pop; only every checkEvery-th call reads
+ * the clock and the cancellation token, so the cost per pop is one increment and one
+ * compare. Once the deadline passes or the token is set, the control stays stopped:
+ * the running search returns and any later search on it returns at once.
+ *
+ * An interrupted search leaves its tentative labels in place. Settled vertices have
+ * their exact distance; any other vertex with a finite label has a valid, possibly
+ * longer, route. The routing functions use this to return a best-effort route with
+ * SEARCH_PARTIAL, or the route of a cheaper fallback engine if one is set (a
+ * DistanceTable or HubLabels lookup, for instance), instead of nothing.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef SEARCHCONTROL_H
+#define SEARCHCONTROL_H
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <functional>
+#include "../data_structs/Graph.h"
+using namespace std;
+
+/**
+ * @brief Outcome of a controlled search or routing call.
+ */
+enum SearchStatus {
+    SEARCH_OK,        ///< complete: the routes are exact (empty if there is none)
+    SEARCH_PARTIAL,   ///< stopped early; the routes are valid but may not be the best
+    SEARCH_TIMED_OUT, ///< the deadline passed before any route was found
+    SEARCH_CANCELLED  ///< the token was set before any route was found
+};
+
+/**
+ * @brief Name of a status, for messages.
+ */
+inline const char *statusName(SearchStatus status) {
+    switch (status) {
+        case SEARCH_OK: return "ok";
+        case SEARCH_PARTIAL: return "partial";
+        case SEARCH_TIMED_OUT: return "timed out";
+        case SEARCH_CANCELLED: return "cancelled";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Cheaper engine used when a routing call stops before finding a route.
+ * @details Called with the graph the call routes on (restrictions already removed),
+ * the source and the destination. Returns true and fills path and weight if it found
+ * a route.
+ */
+typedef function<bool(Graph<int> &, int, int, vector<int> &, int &)> FallbackEngine;
+
+/**
+ * @brief Deadline, cancellation token and fallback engine of a request.
+ */
+class SearchControl {
+public:
+    typedef chrono::steady_clock Clock;
+
+    /**
+     * @param checkEvery Number of heap pops between two checks of the clock and token.
+     */
+    explicit SearchControl(int checkEvery = 256) : checkEvery(checkEvery > 0 ? checkEvery : 1) {}
+
+    /**
+     * @brief Stops the searches at the given time.
+     */
+    void setDeadline(Clock::time_point t) {
+        deadline = t;
+        hasDeadline = true;
+    }
+
+    /**
+     * @brief Stops the searches after the given number of milliseconds from now.
+     */
+    void setTimeout(double ms) {
+        setDeadline(Clock::now() + chrono::duration_cast<Clock::duration>(chrono::duration<double, milli>(ms)));
+    }
+
+    /**
+     * @brief Stops the searches once *token is true; the token is owned by the caller.
+     */
+    void setCancelToken(const atomic<bool> *token) {
+        cancel = token;
+    }
+
+    void setFallback(FallbackEngine engine) {
+        fallback = engine;
+    }
+
+    const FallbackEngine &getFallback() const {
+        return fallback;
+    }
+
+    /**
+     * @brief Called once per heap pop.
+     * @return True if the search must stop.
+     */
+    bool tick() {
+        if (reason != SEARCH_OK) return true;
+        if (++pops < checkEvery) return false;
+        pops = 0;
+        return check();
+    }
+
+    /**
+     * @brief Reads the token and the clock now.
+     * @return True if the search must stop.
+     */
+    bool check() {
+        if (reason != SEARCH_OK) return true;
+        if (cancel != nullptr && cancel->load(memory_order_relaxed)) reason = SEARCH_CANCELLED;
+        else if (hasDeadline && Clock::now() >= deadline) reason = SEARCH_TIMED_OUT;
+        return reason != SEARCH_OK;
+    }
+
+    bool stopped() const {
+        return reason != SEARCH_OK;
+    }
+
+    /**
+     * @brief Why the searches stopped: SEARCH_TIMED_OUT, SEARCH_CANCELLED, or SEARCH_OK if they did not.
+     */
+    SearchStatus stopReason() const {
+        return reason;
+    }
+
+private:
+    int checkEvery;
+    int pops = 0;
+    bool hasDeadline = false;
+    Clock::time_point deadline;
+    const atomic<bool> *cancel = nullptr;
+    FallbackEngine fallback;
+    SearchStatus reason = SEARCH_OK;
+};
+
+#endif //SEARCHCONTROL_H
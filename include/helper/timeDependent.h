@@ -0,0 +1,331 @@
+/**
+ * @file timeDependent.h
+ * @brief Time-dependent routing with per-edge travel-time profiles.
+ * @details Distances.csv holds one static travel time per segment and mode. An optional
+ * profile file refines it with a piecewise-linear travel time by time of day:
+ *
+ *     Location1,Location2,Mode,Profile
+ *     LD3372,QTI,driving,0:3;420:8;600:4;1020:9;1200:3
+ *
+ * Times are minutes since midnight (the day wraps around at 1440) and values are travel
+ * times in the units of Distances.csv. Codes or numeric location IDs may be used.
+ * Identical profiles share one set of breakpoints, stored contiguously for all profiles.
+ * Segments without a profile keep their static weight.
+ *
+ * Profiles must satisfy the FIFO property (leaving later never arrives earlier), i.e.
+ * no segment may get faster by more than one minute per minute; under that assumption
+ * tdDijkstra is exact. Profiles that break it, or that have a time that is not finite
+ * or a travel time that is negative or not finite, are rejected.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef TIMEDEPENDENT_H
+#define TIMEDEPENDENT_H
+
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <queue>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <unordered_map>
+#include "../data_structs/CSRGraph.h"
+#include "removers.h"
+using namespace std;
+
+#define MINUTES_PER_DAY 1440.0
+
+/**
+ * @brief Piecewise-linear travel-time profiles attached to the edges of a CSRGraph.
+ */
+class TravelTimeProfiles {
+public:
+    explicit TravelTimeProfiles(const CSRGraph<int> &g);
+
+    /*
+     * Adds a profile given as (minute, travel time) breakpoints and returns its index.
+     * An identical profile that already exists is reused. Returns -1, adding nothing,
+     * if the profile is empty, has a time or value that is not finite or a negative
+     * value, or breaks FIFO (a slope below -1, including across midnight).
+     */
+    int addProfile(vector<pair<float, float>> points);
+    /*
+     * Attaches a profile to every edge from slot u to slot v. Returns false if there is none.
+     */
+    bool setEdgeProfile(int u, int v, int profile);
+
+    int getNumProfiles() const;
+    int getProfile(int edge) const; // -1 if the edge is static
+
+    /*
+     * Travel time of an edge when entering it at time t (minutes since midnight).
+     * cursor holds the last segment used for each profile and speeds up lookups
+     * for increasing times; it must have getNumProfiles() entries.
+     */
+    double travelTime(int edge, double t, vector<int> &cursor) const;
+
+protected:
+    const CSRGraph<int> &g;
+    vector<int> profileOf;    // edge -> profile (-1 = static weight)
+    vector<int> offsets;      // profile p uses breakpoints [offsets[p], offsets[p+1])
+    vector<float> times;      // breakpoint times, sorted within each profile
+    vector<float> values;     // travel time at each breakpoint
+    unordered_map<string, int> byKey; // profile breakpoints -> profile, for sharing
+
+    double evaluate(int p, double t, int &seg) const;
+};
+
+inline TravelTimeProfiles::TravelTimeProfiles(const CSRGraph<int> &g) : g(g), profileOf(g.getNumEdges(), -1) {
+    offsets.push_back(0);
+}
+
+inline int TravelTimeProfiles::getNumProfiles() const {
+    return offsets.size() - 1;
+}
+
+inline int TravelTimeProfiles::getProfile(int edge) const {
+    return profileOf[edge];
+}
+
+/**
+ * @brief Adds a profile, sharing the breakpoints with an identical existing profile.
+ * @complexity O(B log B), for B breakpoints.
+ */
+inline int TravelTimeProfiles::addProfile(vector<pair<float, float>> points) {
+    if (points.empty()) return -1;
+    for (auto &p : points) {
+        if (!std::isfinite(p.first) || !std::isfinite(p.second) || p.second < 0) return -1;
+        p.first = fmod(p.first, (float) MINUTES_PER_DAY);
+        if (p.first < 0) p.first += MINUTES_PER_DAY;
+    }
+    sort(points.begin(), points.end());
+    size_t n = points.size();
+    for (size_t k = 0; n > 1 && k < n; k++) {
+        // segment k ends at the next breakpoint, or at the first one of the next day
+        double t0 = points[k].first, v0 = points[k].second;
+        double t1 = k + 1 < n ? points[k + 1].first : points[0].first + MINUTES_PER_DAY;
+        double v1 = points[(k + 1) % n].second;
+        if (t1 == t0 ? v1 < v0 : v1 - v0 < -(t1 - t0)) return -1; // arrives earlier by leaving later
+    }
+    string key((const char *) points.data(), points.size() * sizeof(points[0]));
+    auto it = byKey.find(key);
+    if (it != byKey.end()) return it->second;
+
+    for (auto &p : points) {
+        times.push_back(p.first);
+        values.push_back(p.second);
+    }
+    offsets.push_back(times.size());
+    int id = getNumProfiles() - 1;
+    byKey[key] = id;
+    return id;
+}
+
+/**
+ * @brief Attaches a profile to the edges between two slots.
+ * @complexity O(d), where d is the out-degree of u.
+ */
+inline bool TravelTimeProfiles::setEdgeProfile(int u, int v, int profile) {
+    bool found = false;
+    for (int e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+        if (g.getTarget(e) == v) {
+            profileOf[e] = profile;
+            found = true;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Evaluates profile p at time t, starting the search at segment seg.
+ * @details Segment k covers [times[k], times[k+1]); the last one wraps around midnight
+ * to the first breakpoint. The cached segment is checked first, then its successor,
+ * and only then a binary search is made.
+ * @complexity O(1) when t is in the cached segment or the next one, O(log B) otherwise.
+ */
+inline double TravelTimeProfiles::evaluate(int p, double t, int &seg) const {
+    int b = offsets[p], n = offsets[p + 1] - b;
+    if (n == 1) return values[b];
+    t = fmod(t, MINUTES_PER_DAY);
+    if (t < 0) t += MINUTES_PER_DAY;
+    const float *ts = &times[b];
+
+    auto inSeg = [&](int k) {
+        if (k < 0 || k >= n) return false;
+        if (k == n - 1) return t >= ts[n - 1] || t < ts[0];
+        return t >= ts[k] && t < ts[k + 1];
+    };
+    if (!inSeg(seg)) {
+        if (inSeg(seg + 1)) seg++;
+        else {
+            seg = upper_bound(ts, ts + n, (float) t) - ts - 1;
+            if (seg < 0) seg = n - 1;
+        }
+    }
+
+    double t0 = ts[seg], v0 = values[b + seg];
+    double t1 = seg + 1 < n ? ts[seg + 1] : ts[0] + MINUTES_PER_DAY;
+    double v1 = values[b + (seg + 1) % n];
+    double x = t < t0 ? t + MINUTES_PER_DAY : t;
+    return v0 + (v1 - v0) * (x - t0) / (t1 - t0);
+}
+
+inline double TravelTimeProfiles::travelTime(int edge, double t, vector<int> &cursor) const {
+    int p = profileOf[edge];
+    if (p < 0) return g.getWeight(edge);
+    return evaluate(p, t, cursor[p]);
+}
+
+/**
+ * @brief Loads a profile file into a TravelTimeProfiles.
+ * @details Lines that cannot be parsed (every time and value must be a whole number),
+ * use an unknown location, refer to a segment that does not exist or hold a profile
+ * that addProfile rejects are reported on cerr and skipped.
+ *
+ * @param filePath Path to the profile csv file.
+ * @param profiles Profiles of the graph the segments belong to.
+ * @param g CSR graph of the mode being loaded.
+ * @param codes Map of location codes to their IDs (see loadGraphs).
+ * @param mode Mode to load ("driving" or "walking"); rows of other modes are ignored.
+ * @return Number of segments that received a profile.
+ * @complexity O(N (d + B log B)) for N rows.
+ */
+inline int loadProfiles(const string &filePath, TravelTimeProfiles &profiles, const CSRGraph<int> &g,
+                        const unordered_map<string, string> &codes, const string &mode) {
+    ifstream file(filePath);
+    if (!file.is_open()) {
+        cerr << "Error opening file: " << filePath << endl;
+        return 0;
+    }
+    auto slotOf = [&](const string &loc) {
+        auto it = codes.find(loc);
+        int id;
+        const char *p = it != codes.end() ? it->second.data() : loc.data();
+        const char *end = p + (it != codes.end() ? it->second.size() : loc.size());
+        if (!parseInt(p, end, id) || p != end) return -1;
+        return g.findSlot(id);
+    };
+
+    string line, src, dest, m, profile;
+    int lineNo = 1, loaded = 0;
+    getline(file, line); // skip header
+    while (getline(file, line)) {
+        lineNo++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        stringstream ss(line);
+        getline(ss, src, ',');
+        getline(ss, dest, ',');
+        getline(ss, m, ',');
+        getline(ss, profile);
+        if (m != mode) continue;
+
+        int u = slotOf(src), v = slotOf(dest);
+        vector<pair<float, float>> points;
+        stringstream ps(profile);
+        string point;
+        bool ok = u >= 0 && v >= 0;
+        auto number = [](const string &text, float &value) { // the whole text must be a number
+            char *end;
+            value = strtof(text.c_str(), &end);
+            return !text.empty() && end == text.c_str() + text.size();
+        };
+        while (ok && getline(ps, point, ';')) {
+            size_t colon = point.find(':');
+            float t, w;
+            ok = colon != string::npos && number(point.substr(0, colon), t) && number(point.substr(colon + 1), w);
+            if (ok) points.push_back({t, w});
+        }
+        int p = ok ? profiles.addProfile(points) : -1;
+        if (p < 0 || !profiles.setEdgeProfile(u, v, p)) {
+            cerr << "Warning: skipping invalid profile at " << filePath << ":" << lineNo << endl;
+            continue;
+        }
+        loaded++;
+    }
+    return loaded;
+}
+
+/**
+ * @brief Time-dependent shortest-path tree.
+ */
+struct TDTree {
+    vector<double> arrival; ///< slot -> arrival time (INF if unreachable)
+    vector<int> parent;     ///< slot -> edge ID used to reach it (-1 for the source or unreachable)
+};
+
+/**
+ * @brief Time-dependent Dijkstra: earliest arrival from a source at a departure time.
+ * @details Edge costs are evaluated at the time the edge is entered. A cursor per
+ * profile caches the last segment used, so most evaluations are a single comparison.
+ *
+ * @param g CSR graph.
+ * @param profiles Travel-time profiles of g.
+ * @param source Source slot.
+ * @param departure Departure time, in minutes since midnight.
+ * @param tree Receives arrival times (absolute, may exceed 1440) and parent edges.
+ * @complexity O((V + E) log V).
+ */
+inline void tdDijkstra(const CSRGraph<int> &g, const TravelTimeProfiles &profiles, int source,
+                       double departure, TDTree &tree) {
+    int n = g.getNumVertex();
+    tree.arrival.assign(n, INF);
+    tree.parent.assign(n, -1);
+    if (source < 0 || source >= n) return;
+
+    vector<int> cursor(profiles.getNumProfiles(), 0);
+    vector<bool> settled(n, false);
+    typedef pair<double, int> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> q;
+    tree.arrival[source] = departure;
+    q.push({departure, source});
+    while (!q.empty()) {
+        Entry top = q.top();
+        q.pop();
+        int u = top.second;
+        if (settled[u]) continue;
+        settled[u] = true;
+        for (int e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+            int v = g.getTarget(e);
+            if (settled[v]) continue;
+            double t = top.first + profiles.travelTime(e, top.first, cursor);
+            if (t < tree.arrival[v]) {
+                tree.arrival[v] = t;
+                tree.parent[v] = e;
+                q.push({t, v});
+            }
+        }
+    }
+}
+
+/**
+ * @brief Retrieves the path to a slot from a TDTree.
+ * @param g CSR graph the tree was computed on.
+ * @param tree Time-dependent tree.
+ * @param dest Destination slot.
+ * @param departure Departure time used for the tree.
+ * @param duration Receives the travel duration.
+ * @return Vertex IDs of the path, empty if there is none.
+ * @complexity O(P log V), where P is the number of vertices in the path.
+ */
+inline vector<int> tdGetPath(const CSRGraph<int> &g, const TDTree &tree, int dest, double departure, double &duration) {
+    vector<int> res;
+    if (dest < 0 || dest >= g.getNumVertex() || tree.arrival[dest] == INF) return res;
+    duration = tree.arrival[dest] - departure;
+    const vector<int> &off = g.getOffsets();
+    int v = dest;
+    res.push_back(g.getInfo(v));
+    while (tree.parent[v] != -1) {
+        v = upper_bound(off.begin(), off.end(), tree.parent[v]) - off.begin() - 1;
+        res.push_back(g.getInfo(v));
+    }
+    reverse(res.begin(), res.end());
+    return res;
+}
+
+#endif //TIMEDEPENDENT_H
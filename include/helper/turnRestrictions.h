@@ -0,0 +1,279 @@
+/**
+ * @file turnRestrictions.h
+ * @brief Turn restrictions and turn costs, routed on an implicit edge-based graph.
+ * @details avoidSegments can only remove whole segments; it cannot say "no left turn
+ * from A->B onto B->C". Turns are given in an optional csv file:
+ *
+ *     From,Via,To,Penalty
+ *     LD3372,QTI,PR7649,X
+ *     LD3372,QTI,LDDM,2
+ *
+ * Locations are codes or numeric IDs, and a penalty of 'X' forbids the turn (the same
+ * convention as the cuts in Distances.csv). The search runs on the edge-based graph of
+ * a CSRGraph: a state is the edge just traversed and a transition is a turn onto one of
+ * the outgoing edges of its head. That graph is never materialized; only the turns that
+ * have a penalty are stored, grouped by incoming edge ID.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#ifndef TURNRESTRICTIONS_H
+#define TURNRESTRICTIONS_H
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <unordered_map>
+#include "../data_structs/CSRGraph.h"
+#include "csrDijkstra.h"
+#include "removers.h"
+using namespace std;
+
+/**
+ * @brief Turn penalties of a CSRGraph, indexed by incoming edge ID.
+ */
+class TurnTable {
+public:
+    explicit TurnTable(const CSRGraph<int> &g);
+
+    /*
+     * Sets the penalty of turning from every edge u->v onto every edge v->w (slots).
+     * INT_INF forbids the turn. Returns false if either segment does not exist.
+     * finalize() must be called after the last change.
+     */
+    bool addTurn(int u, int v, int w, int penalty);
+    void finalize();
+
+    /*
+     * Penalty added to every U-turn (v->u right after u->v); INT_INF forbids them.
+     */
+    void setUTurnPenalty(int penalty);
+
+    /*
+     * Penalty of turning from edge in onto edge out; INT_INF if forbidden.
+     */
+    int turnCost(int in, int out) const;
+
+    int getOrigin(int edge) const;
+    int getNumTurns() const;
+
+protected:
+    const CSRGraph<int> &g;
+    vector<int> origin;       // edge -> origin slot
+    vector<int> offsets;      // turns of edge e are [offsets[e], offsets[e+1])
+    vector<int> outEdge;      // sorted within each incoming edge
+    vector<int> cost;
+    vector<pair<pair<int, int>, int>> pending; // ((in, out), cost) not yet finalized
+    int uTurnPenalty = 0;
+};
+
+inline TurnTable::TurnTable(const CSRGraph<int> &g) : g(g), origin(g.getNumEdges()), offsets(g.getNumEdges() + 1, 0) {
+    for (int u = 0; u < g.getNumVertex(); u++)
+        for (int e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+            origin[e] = u;
+}
+
+inline int TurnTable::getOrigin(int edge) const {
+    return origin[edge];
+}
+
+inline int TurnTable::getNumTurns() const {
+    return outEdge.size();
+}
+
+inline void TurnTable::setUTurnPenalty(int penalty) {
+    uTurnPenalty = penalty;
+}
+
+/**
+ * @brief Records the penalty of the turns u->v->w.
+ * @complexity O(d(u) * d(v)) in the number of parallel edges, O(d(u) + d(v)) usually.
+ */
+inline bool TurnTable::addTurn(int u, int v, int w, int penalty) {
+    vector<int> ins, outs;
+    for (int e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+        if (g.getTarget(e) == v) ins.push_back(e);
+    for (int e = g.edgeBegin(v); e < g.edgeEnd(v); e++)
+        if (g.getTarget(e) == w) outs.push_back(e);
+    for (int a : ins)
+        for (int b : outs)
+            pending.push_back({{a, b}, penalty});
+    return !ins.empty() && !outs.empty();
+}
+
+/**
+ * @brief Merges the recorded turns into the per-edge arrays.
+ * @details When the same turn is given more than once, the last penalty wins.
+ * @complexity O(E + T log T), for T turns.
+ */
+inline void TurnTable::finalize() {
+    vector<pair<pair<int, int>, int>> all;
+    for (int e = 0; e < g.getNumEdges(); e++)
+        for (int k = offsets[e]; k < offsets[e + 1]; k++)
+            all.push_back({{e, outEdge[k]}, cost[k]});
+    all.insert(all.end(), pending.begin(), pending.end());
+    pending.clear();
+    stable_sort(all.begin(), all.end(),
+                [](const pair<pair<int, int>, int> &a, const pair<pair<int, int>, int> &b) {
+                    return a.first < b.first;
+                });
+
+    outEdge.clear();
+    cost.clear();
+    offsets.assign(g.getNumEdges() + 1, 0);
+    for (size_t i = 0; i < all.size(); i++) {
+        if (i + 1 < all.size() && all[i + 1].first == all[i].first) continue; // keep the last one
+        offsets[all[i].first.first + 1]++;
+        outEdge.push_back(all[i].first.second);
+        cost.push_back(all[i].second);
+    }
+    for (int e = 0; e < g.getNumEdges(); e++)
+        offsets[e + 1] += offsets[e];
+}
+
+/**
+ * @brief Looks up the penalty of a turn.
+ * @complexity O(log t), where t is the number of turns with a penalty from the incoming edge.
+ */
+inline int TurnTable::turnCost(int in, int out) const {
+    int b = offsets[in], e = offsets[in + 1];
+    if (b != e) {
+        auto it = lower_bound(outEdge.begin() + b, outEdge.begin() + e, out);
+        if (it != outEdge.begin() + e && *it == out)
+            return cost[it - outEdge.begin()];
+    }
+    if (g.getTarget(out) == origin[in])
+        return uTurnPenalty;
+    return 0;
+}
+
+/**
+ * @brief Loads a turn file into a TurnTable.
+ * @details Invalid lines, unknown locations and turns over missing segments are
+ * reported on cerr and skipped; a numeric penalty must be below INT_INF, which is
+ * reserved for 'X'. Calls finalize() at the end.
+ *
+ * @param filePath Path to the turns csv file.
+ * @param turns Table to fill.
+ * @param g CSR graph of the mode being loaded.
+ * @param codes Map of location codes to their IDs (see loadGraphs).
+ * @return Number of turns loaded.
+ * @complexity O(N d + T log T), for N rows.
+ */
+inline int loadTurns(const string &filePath, TurnTable &turns, const CSRGraph<int> &g,
+                     const unordered_map<string, string> &codes) {
+    ifstream file(filePath);
+    if (!file.is_open()) {
+        cerr << "Error opening file: " << filePath << endl;
+        return 0;
+    }
+    auto slotOf = [&](const string &loc) {
+        auto it = codes.find(loc);
+        const string &s = it != codes.end() ? it->second : loc;
+        const char *p = s.data(), *end = p + s.size();
+        int id;
+        if (!parseInt(p, end, id) || p != end) return -1;
+        return g.findSlot(id);
+    };
+
+    string line, from, via, to, penalty;
+    int lineNo = 1, loaded = 0;
+    getline(file, line); // skip header
+    while (getline(file, line)) {
+        lineNo++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        stringstream ss(line);
+        getline(ss, from, ',');
+        getline(ss, via, ',');
+        getline(ss, to, ',');
+        getline(ss, penalty, ',');
+
+        int u = slotOf(from), v = slotOf(via), w = slotOf(to), p = INT_INF;
+        const char *pb = penalty.data(), *pe = pb + penalty.size();
+        bool ok = u >= 0 && v >= 0 && w >= 0 && (penalty == "X" || (parseInt(pb, pe, p) && pb == pe && p >= 0 && p < INT_INF));
+        if (!ok || !turns.addTurn(u, v, w, p)) {
+            cerr << "Warning: skipping invalid turn at " << filePath << ":" << lineNo << endl;
+            continue;
+        }
+        loaded++;
+    }
+    turns.finalize();
+    return loaded;
+}
+
+/**
+ * @brief Shortest route that respects turn restrictions and turn costs.
+ * @details Dijkstra over edge states: dist[e] is the cost of arriving at the head of e
+ * through e. Starting states are the outgoing edges of the source; the first settled
+ * edge whose head is the destination ends the search.
+ *
+ * @param g CSR graph.
+ * @param turns Turn penalties of g.
+ * @param source Source slot.
+ * @param dest Destination slot.
+ * @param w Receives the route cost, turn penalties included.
+ * @return Vertex IDs of the route, empty if there is none.
+ * @complexity O((E + T') log E), where T' is the number of turns examined.
+ */
+inline vector<int> turnAwareRoute(const CSRGraph<int> &g, const TurnTable &turns, int source, int dest, int &w) {
+    vector<int> res;
+    int n = g.getNumVertex(), m = g.getNumEdges();
+    if (source < 0 || source >= n || dest < 0 || dest >= n) return res;
+    if (source == dest) {
+        w = 0;
+        res.push_back(g.getInfo(source));
+        return res;
+    }
+
+    vector<int> dist(m, INT_INF), pred(m, -1);
+    vector<bool> settled(m, false);
+    typedef pair<int, int> Entry; // (distance, edge)
+    priority_queue<Entry, vector<Entry>, greater<Entry>> q;
+    for (int e = g.edgeBegin(source); e < g.edgeEnd(source); e++) {
+        if (g.getWeight(e) < dist[e]) {
+            dist[e] = g.getWeight(e);
+            q.push({dist[e], e});
+        }
+    }
+
+    int last = -1;
+    while (!q.empty()) {
+        Entry top = q.top();
+        q.pop();
+        int e = top.second;
+        if (settled[e]) continue;
+        settled[e] = true;
+        int v = g.getTarget(e);
+        if (v == dest) {
+            last = e;
+            break;
+        }
+        for (int f = g.edgeBegin(v); f < g.edgeEnd(v); f++) {
+            if (settled[f]) continue;
+            int tc = turns.turnCost(e, f);
+            if (tc == INT_INF) continue;
+            long long nd = (long long) top.first + tc + g.getWeight(f); // no overflow on huge penalties
+            if (nd < dist[f]) {
+                dist[f] = (int) nd;
+                pred[f] = e;
+                q.push({nd, f});
+            }
+        }
+    }
+    if (last == -1) return res;
+
+    w = dist[last];
+    for (int e = last; e != -1; e = pred[e])
+        res.push_back(g.getInfo(g.getTarget(e)));
+    res.push_back(g.getInfo(source));
+    reverse(res.begin(), res.end());
+    return res;
+}
+
+#endif //TURNRESTRICTIONS_H
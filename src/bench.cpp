@@ -0,0 +1,630 @@
+/**
+ * @file bench.cpp
+ * @brief Query throughput benchmark, also used to train the profile-guided builds.
+ * @details Answers a fixed, seeded set of queries on the data in data/, the same way
+ * best-route does (graphs built from a snapshot, then Routing or avoidRouting), and
+ * the same number of unrestricted queries over a tenth as many sources, one by one
+ * and as a batch. Then runs csrDijkstra from every location, first on one thread and
+ * then on pinned threads reading per-NUMA-node replicas, and loads the csv files both as
+ * two graphs with their CSR copies and as one MultiLayerGraph, whose driving layer is
+ * searched from every location and checked against the CSR trees. Prints the time and
+ * throughput of each, and the memory report (allocation counts per subsystem and per
+ * query in the memstats build, peak RSS always).
+ *
+ * With "check", instead validates the engines against each other (see runChecks) and
+ * exits with a non-zero status on a mismatch; make check, release and pgo run it on the
+ * code they build. With "reorder", times dijkstra from every location before and after
+ * reorderGraphs (see runReorder).
+ *
+ * Usage: bench [queries] [threads per node]
+ *        bench check
+ *        bench reorder [bfs|rcm|hilbert]
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <unistd.h>
+#include "helper/hotReload.h"
+#include "helper/locationResolver.h"
+#include "helper/routing.h"
+#include "helper/batchPlanner.h"
+#include "helper/csrDijkstra.h"
+#include "helper/Dijkstra.h"
+#include "helper/numa.h"
+#include "helper/memoryStats.h"
+#include "helper/csvLoader.h"
+#include "helper/reorder.h"
+#include "helper/hubLabels.h"
+#include "helper/overlay.h"
+#include "helper/distanceTable.h"
+#include "data_structs/CSRGraph.h"
+
+using namespace std;
+
+/**
+ * @brief Milliseconds elapsed since a starting point.
+ */
+static double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Compares csrDijkstra, with each relaxation kernel, against dijkstra.
+ * @details Runs every kernel from every vertex: the distances must equal the ones of
+ * dijkstra on the pointer-based graph, and the kernels must pick the same parent edges.
+ * @return Number of sources with a mismatch.
+ */
+static int checkKernels(Graph<int> &g, const string &label) {
+    CSRGraph<int> csr(g);
+    vector<pair<string, RelaxKernel>> kernels = {{"scalar", relaxScalar}};
+#ifdef CSR_HAS_AVX2_KERNEL
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) kernels.push_back({"avx2", relaxAVX2});
+#endif
+    int mismatches = 0;
+    vector<ShortestPathTree> trees(kernels.size());
+    for (int s = 0; s < csr.getNumVertex(); s++) {
+        dijkstra(&g, csr.getInfo(s));
+        bool ok = true;
+        for (size_t k = 0; k < kernels.size(); k++) {
+            csrDijkstra(csr, s, trees[k], kernels[k].second);
+            for (int t = 0; t < csr.getNumVertex() && ok; t++) {
+                double d = g.findVertex(csr.getInfo(t))->getDist();
+                ok = trees[k].dist[t] == (d == INF ? INT_INF : (int) lround(d));
+            }
+            ok = ok && trees[k].parent == trees[0].parent;
+        }
+        mismatches += !ok;
+    }
+    cout << "check " << label << ": " << csr.getNumVertex() << " sources, kernels";
+    for (auto &k : kernels) cout << " " << k.first;
+    cout << " against dijkstra: " << (mismatches == 0 ? "ok" : to_string(mismatches) + " mismatching sources")
+         << endl;
+    return mismatches;
+}
+
+/**
+ * @brief Random graph with a few high-degree vertices and parallel edges, so that the
+ * vector kernel sees full blocks, tails and repeated targets within a block.
+ */
+static void syntheticGraph(Graph<int> &g, int n, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> vertex(1, n), weight(1, 50), degree(0, 5), hubDegree(8, 40);
+    for (int i = 1; i <= n; i++) g.addVertex(i);
+    for (int u = 1; u <= n; u++) {
+        int d = u % 17 == 0 ? hubDegree(rng) : degree(rng);
+        for (int k = 0; k < d; k++) {
+            int v = k % 7 == 6 ? vertex(rng) % 4 + 1 : vertex(rng); // some repeated targets
+            g.addEdge(u, v, weight(rng));
+        }
+    }
+}
+
+/**
+ * @brief Locations of a snapshot as ID -> (parking, sorted driving and walking edges by
+ * target ID), so that snapshots with different slot numbers can be compared.
+ */
+static map<int, string> describeSnapshot(const NetworkSnapshot &net) {
+    map<int, string> res;
+    for (int s = 0; s < net.getNumSlots(); s++) {
+        const SnapshotVertex &v = net.getVertex(s);
+        if (!v.present) continue;
+        ostringstream out;
+        out << v.parking;
+        for (auto *edges : {&v.drive, &v.walk}) {
+            vector<pair<int, int>> byId;
+            for (auto &e : *edges)
+                if (net.getVertex(e.first).present) byId.push_back({net.getVertex(e.first).id, e.second});
+            sort(byId.begin(), byId.end());
+            out << '|';
+            for (auto &e : byId) out << e.first << ':' << e.second << ' ';
+        }
+        res[v.id] = out.str();
+    }
+    return res;
+}
+
+/**
+ * @brief Locations of the graphs filled by the csv loaders, in the format of
+ * describeSnapshot.
+ */
+static map<int, string> describeGraphs(const Graph<int> &drive, const Graph<int> &walk) {
+    map<int, string> res;
+    for (auto v : drive.getVertexSet()) {
+        ostringstream out;
+        out << v->hasParking();
+        for (auto u : {v, walk.findVertex(v->getInfo())}) {
+            vector<pair<int, int>> byId;
+            for (auto e : u->getAdj()) byId.push_back({e->getDest()->getInfo(), (int) lround(e->getWeight())});
+            sort(byId.begin(), byId.end());
+            out << '|';
+            for (auto &e : byId) out << e.first << ':' << e.second << ' ';
+        }
+        res[v->getInfo()] = out.str();
+    }
+    return res;
+}
+
+/**
+ * @brief Number of locations that are missing from one description or differ.
+ */
+static int countDifferences(const map<int, string> &a, const map<int, string> &b) {
+    int differences = 0;
+    for (auto &v : a) {
+        auto it = b.find(v.first);
+        differences += it == b.end() || it->second != v.second;
+    }
+    for (auto &v : b) differences += !a.count(v.first);
+    return differences;
+}
+
+/**
+ * @brief Compares NetworkStore with the csv loaders and an incremental reload with a
+ * fresh load of the same files.
+ * @details Copies data/ to a temporary directory with invalid rows (an ID and a parking
+ * flag that are not integers, a negative time, a row with one invalid time) and checks
+ * that NetworkStore keeps what loadLocations and loadDistances keep, and that a
+ * LocationResolver built from the snapshot knows the same locations. Then renames the
+ * code of the first location in both files, changes the parking flag of the second one,
+ * reloads and compares with a fresh NetworkStore, with the loaders and with the
+ * resolver again.
+ * @return Number of locations that differ (-1 if the files could not be prepared).
+ */
+static int checkReload() {
+    char dir[] = "/tmp/bench-reloadXXXXXX";
+    if (mkdtemp(dir) == nullptr) return -1;
+    string locFile = string(dir) + "/Locations.csv", distFile = string(dir) + "/Distances.csv";
+    vector<string> locRows, distRows;
+    string line;
+    ifstream loc("data/Locations.csv"), dist("data/Distances.csv");
+    while (getline(loc, line)) locRows.push_back(line);
+    while (getline(dist, line)) distRows.push_back(line);
+    if (locRows.size() < 3 || distRows.empty()) return -1;
+    auto write = [](const string &path, const vector<string> &rows) {
+        ofstream out(path);
+        for (auto &r : rows) out << r << '\n';
+    };
+    auto field = [](const string &row, int k) { // k-th comma-separated field
+        size_t b = 0;
+        for (int i = 0; i < k; i++) b = row.find(',', b) + 1;
+        return row.substr(b, row.find(',', b) - b);
+    };
+    auto loaded = [&]() { // what the csv loaders keep of the files
+        Graph<int> d, w;
+        unordered_map<string, string> codes;
+        loadLocations(locFile, d, w, codes);
+        loadDistances(distFile, codes, d, w);
+        return describeGraphs(d, w);
+    };
+    string first = field(locRows[3], 2), second = field(locRows[4], 2);
+    // rows skipped as invalid by every loader
+    locRows.push_back("Bogus,abc,BOGUS,0");
+    locRows.push_back("BadParking,99990,BADP,1x");
+    locRows.push_back("Added,99991,ADDED,0");
+    distRows.push_back(first + "," + second + ",-3,4");
+    distRows.push_back(first + "," + second + ",abc,5");
+    distRows.push_back(first + ",ADDED,5,abc");
+    distRows.push_back("ADDED," + second + ",6,7"); // valid
+    write(locFile, locRows);
+    write(distFile, distRows);
+    NetworkStore store(locFile, distFile);
+    auto unresolved = [](const NetworkSnapshot &net) { // locations the resolver and the snapshot disagree on
+        LocationResolver resolver;
+        resolver.load(net.getLocationLines());
+        int present = 0, missing = 0;
+        for (int s = 0; s < net.getNumSlots(); s++) {
+            if (!net.getVertex(s).present) continue;
+            present++;
+            missing += resolver.findId(net.getVertex(s).id) == nullptr;
+        }
+        return missing + abs(resolver.size() - present);
+    };
+    int differences = countDifferences(describeSnapshot(*store.snapshot()), loaded());
+    differences += unresolved(*store.snapshot());
+
+    string code = field(locRows[1], 2), renamed = "RENAMED" + code;
+    locRows[1] = field(locRows[1], 0) + "," + field(locRows[1], 1) + "," + renamed + "," + field(locRows[1], 3);
+    locRows[2] = field(locRows[2], 0) + "," + field(locRows[2], 1) + "," + field(locRows[2], 2) + ","
+                 + (field(locRows[2], 3) == "1" ? "0" : "1");
+    for (size_t i = 1; i < distRows.size(); i++) {
+        string a = field(distRows[i], 0), b = field(distRows[i], 1);
+        if (a != code && b != code) continue;
+        distRows[i] = (a == code ? renamed : a) + "," + (b == code ? renamed : b)
+                      + distRows[i].substr(a.size() + b.size() + 1);
+    }
+    write(locFile, locRows);
+    write(distFile, distRows);
+    store.reload();
+    NetworkStore fresh(locFile, distFile);
+    map<int, string> reloaded = describeSnapshot(*store.snapshot());
+    differences += countDifferences(reloaded, describeSnapshot(*fresh.snapshot()));
+    differences += countDifferences(reloaded, loaded());
+    differences += unresolved(*store.snapshot());
+    unlink(locFile.c_str());
+    unlink(distFile.c_str());
+    rmdir(dir);
+    cout << "check NetworkStore with invalid rows and a reload after renaming " << code
+         << " against the csv loaders, a fresh load and the location resolver: "
+         << (differences == 0 ? "ok" : to_string(differences) + " differing locations") << endl;
+    return differences;
+}
+
+/**
+ * @brief Compares HubLabels, as built and after a save/load round trip, with csrDijkstra.
+ * @details Every pair of vertices is queried on both labelings. Then the file is
+ * corrupted with a decreasing out-label offset, which load must reject.
+ * @return Number of sources with a mismatch (plus one if a load did not behave).
+ */
+static int checkHubLabels(const CSRGraph<int> &csr, const string &label) {
+    char path[] = "/tmp/bench-labelsXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) return 1;
+    close(fd);
+    HubLabels built, loaded;
+    built.build(csr);
+    int mismatches = !built.save(path) || !loaded.load(path);
+    ShortestPathTree tree;
+    for (int s = 0; s < csr.getNumVertex() && mismatches == 0; s++) {
+        csrDijkstra(csr, s, tree);
+        bool ok = true;
+        for (int t = 0; t < csr.getNumVertex() && ok; t++)
+            ok = built.distanceSlots(s, t) == tree.dist[t] && loaded.distanceSlots(s, t) == tree.dist[t];
+        mismatches += !ok;
+    }
+    if (csr.getNumVertex() >= 2) {
+        uint32_t bad = built.getNumEntries() + 1; // out offset of slot 1, above the end
+        fstream file(path, ios::in | ios::out | ios::binary);
+        file.seekp((5 + csr.getNumVertex() + 1) * sizeof(uint32_t));
+        file.write((const char *) &bad, sizeof(bad));
+        file.close();
+        HubLabels corrupt;
+        mismatches += corrupt.load(path);
+    }
+    unlink(path);
+    cout << "check " << label << ": hub labels (" << built.getNumEntries() << " entries), built and loaded, "
+         << "against csrDijkstra: " << (mismatches == 0 ? "ok" : to_string(mismatches) + " mismatches") << endl;
+    return mismatches;
+}
+
+/**
+ * @brief Weight of a route given as vertex IDs, taking the lightest open edge between
+ * consecutive vertices; -1 if some pair has no open edge.
+ * @param weight Edge ID -> current weight (INT_INF if closed).
+ */
+template <class W>
+static long long pathWeight(const CSRGraph<int> &csr, const vector<int> &path, W weight) {
+    long long sum = 0;
+    for (size_t i = 0; i + 1 < path.size(); i++) {
+        int u = csr.findSlot(path[i]), v = csr.findSlot(path[i + 1]), best = INT_INF;
+        if (u < 0 || v < 0) return -1;
+        for (int e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++)
+            if (csr.getTarget(e) == v) best = min(best, weight(e));
+        if (best == INT_INF) return -1;
+        sum += best;
+    }
+    return sum;
+}
+
+/**
+ * @brief Compares OverlayGraph routes with csrDijkstra, after customize() and again after
+ * changing weights and re-customizing.
+ * @details The weight changes raise, lower and close (INT_INF) some edges; the reference
+ * is a graph rebuilt with the new weights, without the closed edges. Every route must
+ * have the weight of the reference distance and follow open edges adding up to it.
+ * @return Number of sources with a mismatch.
+ */
+static int checkOverlay(const CSRGraph<int> &csr, const string &label) {
+    int n = csr.getNumVertex();
+    OverlayGraph overlay(csr, partitionGraph(csr, 32));
+    int customized = overlay.customize();
+    int mismatches = 0;
+    auto compare = [&]() {
+        Graph<int> metric; // the overlay metric, without closed edges
+        for (int v = 0; v < n; v++) metric.addVertex(csr.getInfo(v));
+        for (int u = 0; u < n; u++)
+            for (int e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++)
+                if (overlay.getWeight(e) < INT_INF)
+                    metric.addEdge(csr.getInfo(u), csr.getInfo(csr.getTarget(e)), overlay.getWeight(e));
+        CSRGraph<int> reference(metric);
+        ShortestPathTree tree;
+        for (int s = 0; s < n; s++) {
+            csrDijkstra(reference, s, tree);
+            bool ok = true;
+            for (int k = 0; k < 16 && ok; k++) { // a spread of destinations per source
+                int t = (s * 37 + k * 101) % n, w = INT_INF;
+                vector<int> path = overlay.route(csr.getInfo(s), csr.getInfo(t), w);
+                ok = path.empty() ? tree.dist[t] == INT_INF
+                                  : w == tree.dist[t] && path.front() == csr.getInfo(s) && path.back() == csr.getInfo(t)
+                                    && pathWeight(csr, path, [&](int e) { return overlay.getWeight(e); }) == w;
+            }
+            mismatches += !ok;
+        }
+    };
+    compare();
+    for (int e = 0; e < csr.getNumEdges(); e++) {
+        if (e % 53 == 0) overlay.setWeight(e, overlay.getWeight(e) * 3 + 1);
+        else if (e % 53 == 17) overlay.setWeight(e, 1);
+        else if (e % 53 == 31) overlay.setWeight(e, INT_INF);
+    }
+    int recustomized = overlay.customize();
+    compare();
+    cout << "check " << label << ": overlay routes (" << overlay.getNumCells() << " cells, " << customized
+         << " customized, " << recustomized << " after weight changes) against csrDijkstra: "
+         << (mismatches == 0 ? "ok" : to_string(mismatches) + " mismatching sources") << endl;
+    return mismatches;
+}
+
+/**
+ * @brief Compares DistanceTable, built per source and with Floyd-Warshall and after a
+ * save/load round trip, with csrDijkstra.
+ * @details Every pair must have the csrDijkstra distance, and path() a route between
+ * the pair whose edges add up to it. A file whose header states more vertices than it
+ * holds must be rejected by load.
+ * @return Number of sources with a mismatch (plus one per load that did not behave).
+ */
+static int checkDistanceTable(const CSRGraph<int> &csr, const string &label) {
+    char path[] = "/tmp/bench-tableXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) return 1;
+    close(fd);
+    int n = csr.getNumVertex(), mismatches = 0;
+    vector<ShortestPathTree> trees(n);
+    for (int s = 0; s < n; s++) csrDijkstra(csr, s, trees[s]);
+    for (TableMethod method : {TABLE_SSSP, TABLE_FLOYD_WARSHALL}) {
+        DistanceTable built, loaded;
+        built.build(csr, method);
+        mismatches += !built.save(path) || !loaded.load(path);
+        for (const DistanceTable *table : {&built, &loaded}) {
+            for (int s = 0; s < n; s++) {
+                bool ok = true;
+                for (int t = 0; t < n && ok; t++) {
+                    int d = trees[s].dist[t], w = INT_INF;
+                    ok = table->distanceSlots(s, t) == d && table->nextHop(s, t) == built.nextHop(s, t);
+                    if (table != &built) continue; // same next hops, so the same paths
+                    vector<int> route = table->path(csr.getInfo(s), csr.getInfo(t), w);
+                    ok = ok && (route.empty() ? d == INT_INF
+                                        : w == d && route.front() == csr.getInfo(s) && route.back() == csr.getInfo(t)
+                                          && pathWeight(csr, route, [&](int e) { return csr.getWeight(e); }) == d);
+                }
+                mismatches += !ok;
+            }
+        }
+    }
+    uint32_t huge = 0x7fffffff; // stated vertex count
+    fstream file(path, ios::in | ios::out | ios::binary);
+    file.seekp(2 * sizeof(uint32_t));
+    file.write((const char *) &huge, sizeof(huge));
+    file.close();
+    DistanceTable corrupt;
+    mismatches += corrupt.load(path);
+    unlink(path);
+    cout << "check " << label << ": distance tables (per source and Floyd-Warshall, built and loaded) and "
+         << "their paths against csrDijkstra: " << (mismatches == 0 ? "ok" : to_string(mismatches) + " mismatches")
+         << endl;
+    return mismatches;
+}
+
+/**
+ * @brief Self-checks run by "bench check": search kernels, hub labels, overlay routing,
+ * distance tables and incremental reload.
+ * @return Process exit status: 0 if everything matched.
+ */
+static int runChecks() {
+    int failures = 0;
+    auto checkGraph = [&](Graph<int> &g, const string &label) {
+        failures += checkKernels(g, label) != 0;
+        CSRGraph<int> csr(g);
+        failures += checkHubLabels(csr, label) != 0;
+        failures += checkOverlay(csr, label) != 0;
+        failures += checkDistanceTable(csr, label) != 0;
+    };
+    Graph<int> drive, walk;
+    loadGraphs(drive, walk);
+    checkGraph(drive, "data/Distances.csv driving");
+    checkGraph(walk, "data/Distances.csv walking");
+    for (unsigned seed = 1; seed <= 4; seed++) {
+        Graph<int> g;
+        syntheticGraph(g, 400, seed);
+        checkGraph(g, "synthetic graph " + to_string(seed));
+    }
+    failures += checkReload() != 0;
+    return failures == 0 ? 0 : EXIT_FAILURE;
+}
+
+/**
+ * @brief Runs dijkstra from every source and returns the time spent in the searches.
+ * @param column Location ID -> column of dist, so that the distances of graphs in
+ * different orders can be compared.
+ * @param dist Filled with the distance from every source to every location.
+ */
+static double timeDijkstra(Graph<int> &g, const vector<int> &sources, const unordered_map<int, int> &column,
+                           vector<vector<double>> &dist) {
+    double ms = 0;
+    dist.assign(sources.size(), vector<double>(column.size(), INF));
+    for (size_t i = 0; i < sources.size(); i++) {
+        auto start = chrono::steady_clock::now();
+        dijkstra(&g, sources[i]);
+        ms += elapsedMs(start);
+        for (auto v : g.getVertexSet()) dist[i][column.at(v->getInfo())] = v->getDist();
+    }
+    return ms;
+}
+
+/**
+ * @brief Times dijkstra from every location on the graphs of loadGraphs, before and
+ * after reorderGraphs, and checks that every distance is the same.
+ * @return Process exit status: 0 if the graphs were reordered and the distances match.
+ */
+static int runReorder(const string &name) {
+    map<string, OrderingMethod> methods = {{"bfs", ORDER_BFS}, {"rcm", ORDER_RCM}, {"hilbert", ORDER_HILBERT}};
+    if (!methods.count(name)) {
+        cerr << "Error: unknown ordering " << name << " (bfs, rcm or hilbert)" << endl;
+        return EXIT_FAILURE;
+    }
+    Graph<int> drive, walk;
+    loadGraphs(drive, walk);
+    vector<int> sources;
+    unordered_map<int, int> column;
+    for (auto v : drive.getVertexSet()) {
+        column[v->getInfo()] = sources.size();
+        sources.push_back(v->getInfo());
+    }
+
+    vector<vector<double>> driveBefore, walkBefore, driveAfter, walkAfter;
+    double driveMs = timeDijkstra(drive, sources, column, driveBefore);
+    double walkMs = timeDijkstra(walk, sources, column, walkBefore);
+    VertexOrder<int> order;
+    auto start = chrono::steady_clock::now();
+    if (!reorderGraphs(drive, walk, methods[name], order)) {
+        cerr << "Error: the driving and walking graphs do not have the same locations" << endl;
+        return EXIT_FAILURE;
+    }
+    double reorderMs = elapsedMs(start);
+    double driveAfterMs = timeDijkstra(drive, sources, column, driveAfter);
+    double walkAfterMs = timeDijkstra(walk, sources, column, walkAfter);
+    bool same = driveBefore == driveAfter && walkBefore == walkAfter;
+
+    cout << "reorder " << name << ": " << sources.size() << " locations reordered in " << reorderMs << " ms" << endl;
+    cout << "dijkstra from every location, driving: " << driveMs << " ms before, " << driveAfterMs << " ms after"
+         << endl;
+    cout << "dijkstra from every location, walking: " << walkMs << " ms before, " << walkAfterMs << " ms after"
+         << endl;
+    cout << "distances after reordering: " << (same ? "same" : "DIFFERENT") << endl;
+    return same ? 0 : EXIT_FAILURE;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && string(argv[1]) == "check") return runChecks();
+    if (argc > 1 && string(argv[1]) == "reorder") return runReorder(argc > 2 ? argv[2] : "rcm");
+    int queries = argc > 1 ? atoi(argv[1]) : 300;
+    NetworkStore store;
+    shared_ptr<const NetworkSnapshot> net = store.snapshot();
+    Graph<int> drive, walk;
+    net->fillGraphs(drive, walk);
+    vector<int> ids;
+    for (auto v : drive.getVertexSet()) ids.push_back(v->getInfo());
+    if (ids.size() < 2) {
+        cerr << "Error: no locations loaded" << endl;
+        return EXIT_FAILURE;
+    }
+
+    mt19937 rng(42);
+    uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+    long long checksum = 0;
+    MemoryUsage memStart = memoryUsage();
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < queries; i++) {
+        int source = ids[pick(rng)], destination = ids[pick(rng)];
+        Graph<int> d, w;
+        net->fillGraphs(d, w);
+        if (i % 4 == 3) { // every fourth query is restricted
+            vector<int> path;
+            int weight = 0;
+            avoidRouting(d, source, destination, {ids[pick(rng)]}, {}, 0, path, weight);
+            checksum += weight;
+        }
+        else {
+            vector<int> primPath, secPath;
+            int primW = 0, secW = 0;
+            Routing(d, source, destination, primPath, secPath, primW, secW);
+            checksum += primW + secW;
+        }
+    }
+    double routingMs = elapsedMs(start);
+    MemCounters routingMem = memoryDelta(memStart, memoryUsage());
+
+    vector<RouteQuery> batch(queries);
+    vector<int> sources;
+    for (int i = 0; i < max(1, queries / 10); i++) sources.push_back(ids[pick(rng)]);
+    for (auto &q : batch) {
+        q.source = sources[pick(rng) % sources.size()];
+        q.destination = ids[pick(rng)];
+    }
+    start = chrono::steady_clock::now();
+    for (auto &q : batch) checksum += answerQuery(q, *net).secW;
+    double singleMs = elapsedMs(start);
+    start = chrono::steady_clock::now();
+    BatchStats stats;
+    for (auto &a : answerBatch(batch, *net, &stats)) checksum += a.secW;
+    double batchMs = elapsedMs(start);
+
+    CSRGraph<int> csr(drive);
+    ShortestPathTree tree;
+    start = chrono::steady_clock::now();
+    for (int s = 0; s < csr.getNumVertex(); s++) {
+        csrDijkstra(csr, s, tree);
+        checksum += tree.dist[(s + 1) % csr.getNumVertex()] == INT_INF ? 0 : 1;
+    }
+    double csrMs = elapsedMs(start);
+
+    unsigned threadsPerNode = argc > 2 ? atoi(argv[2]) : 0; // 0: one per CPU
+    NumaReplicas<int> replicas(csr);
+    atomic<int> nextSource(0);
+    atomic<unsigned> workers(0);
+    start = chrono::steady_clock::now();
+    replicas.forEachWorker(threadsPerNode, [&](const CSRGraph<int> &local, unsigned, unsigned) {
+        ShortestPathTree localTree;
+        workers++;
+        for (int s = nextSource++; s < local.getNumVertex(); s = nextSource++) csrDijkstra(local, s, localTree);
+    });
+    double numaMs = elapsedMs(start);
+
+    MemoryUsage loadStart = memoryUsage();
+    start = chrono::steady_clock::now();
+    long long twoGraphsBytes = 0, layeredBytes = 0;
+    {
+        Graph<int> d, w;
+        loadGraphs(d, w);
+        CSRGraph<int> dc(d), wc(w);
+        twoGraphsBytes = memoryDelta(loadStart, memoryUsage()).current;
+    }
+    double twoGraphsMs = elapsedMs(start);
+    loadStart = memoryUsage();
+    start = chrono::steady_clock::now();
+    MultiLayerGraph<int> layered;
+    loadNetwork("data/Locations.csv", "data/Distances.csv", layered);
+    double layeredMs = elapsedMs(start);
+    layeredBytes = memoryDelta(loadStart, memoryUsage()).current;
+    const GraphLayer<int> &driveLayer = layered.getLayer(LAYER_DRIVE);
+    int layerMismatches = 0;
+    ShortestPathTree layerTree;
+    start = chrono::steady_clock::now();
+    for (int s = 0; s < driveLayer.getNumVertex(); s++) {
+        csrDijkstra(driveLayer, s, layerTree);
+        if (s % 16 == 0) { // spot check against the CSR copy of the driving graph
+            csrDijkstra(csr, s, tree);
+            layerMismatches += layerTree.dist != tree.dist;
+        }
+    }
+    double layerMs = elapsedMs(start);
+
+    cout << "routing: " << queries << " queries in " << routingMs << " ms ("
+         << (routingMs > 0 ? queries * 1000.0 / routingMs : 0) << " queries/s)" << endl;
+    cout << "same-source queries: " << queries << " one by one in " << singleMs << " ms, as a batch ("
+         << stats.trees << " trees) in " << batchMs << " ms" << endl;
+    cout << "csrDijkstra: " << csr.getNumVertex() << " trees in " << csrMs << " ms ("
+         << (csrMs > 0 ? csr.getNumVertex() * 1000.0 / csrMs : 0) << " trees/s)" << endl;
+    cout << "csrDijkstra on " << replicas.getNumNodes() << " NUMA node replica(s), " << workers << " threads: "
+         << csr.getNumVertex() << " trees in " << numaMs << " ms ("
+         << (numaMs > 0 ? csr.getNumVertex() * 1000.0 / numaMs : 0) << " trees/s)" << endl;
+    cout << "multi-layer graph: loaded in " << layeredMs << " ms (two graphs and CSR copies: " << twoGraphsMs
+         << " ms); driving layer searched from every location in " << layerMs << " ms, "
+         << layerMismatches << " mismatches with the CSR trees" << endl;
+    if (memoryHooksEnabled()) {
+        cout << "multi-layer graph: " << layeredBytes << " bytes (two graphs and CSR copies: "
+             << twoGraphsBytes << " bytes)" << endl;
+        cout << "routing allocations: " << (double) routingMem.allocs / queries << " per query ("
+             << (double) routingMem.allocated / queries << " bytes per query)" << endl;
+    }
+    printMemoryReport(cout, memoryUsage());
+    cout << "checksum: " << checksum << endl;
+    return 0;
+}
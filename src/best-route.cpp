@@ -3,31 +3,34 @@
  * @brief Implements routing functionality using Dijkstra's algorithm.
  * @details This program allows users to find optimal and restricted routes
  * using a graph-based approach. It supports command-line, for faster
- * testing of the code, and file-based input.
+ * testing of the code, and file-based input. Files may hold several
+ * queries, which are answered in order.
  * 
  * @authors João Júnior, Mário Pereira, Vasco Sá
  */
 
 #include <iostream>
-#include "helper/csvLoader.h"
+#include <fstream>
 #include "data_structs/Graph.h"
 #include "helper/Dijkstra.h"
-#include "helper/inputLoader.h"
+#include "helper/queryParser.h"
 #include "helper/routing.h"
+#include "helper/resultWriter.h"
+#include "helper/hotReload.h"
+#include "helper/batchPlanner.h"
+#include "helper/memoryStats.h"
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace std;
 
 string test; ///< Mode of input: "cmd" for command-line, "file" for file-based input.
-int type = 0; ///< Route type: 0 for alternativeRoute, 1 for restrictedRoute.
-
-string mode;
-int source, destination;
-string N, S, temp; int I = 0; ///< Used for "avoidNodes", "avoidSegments", "includeNode".
-vector<bool> NSI; ///< Used for triggering what of the above is used to calculate the restricted route.
+string cmdLine; ///< Query typed in "cmd" mode.
 
 /**
  * @brief Displays the menu and handles user input.
- * @details Parses input from command line or file to set up routing parameters.
+ * @details Reads the input mode and, in "cmd" mode, the query line.
+ * The query itself is parsed and validated in results(), once the graph is loaded.
  * @complexity O(1), assuming standard input size.
  */
 void menu() {
@@ -36,136 +39,121 @@ void menu() {
     
     if (test == "cmd") {
         cout << "Enter mode, source, destination, avoidNodes*, avoidSegments*, includeNode* (use '_' if empty): ";
-        cin >> mode >> source >> destination >> N >> S >> temp;
-
-        if (temp == "_") {I = 0;}
-        else {I = stoi(temp);}
-
-        NSI = {N != "_", S != "_", I != 0};
-        type = (NSI[0] || NSI[1] || NSI[2]) ? 1 : 0;
-    }
-    else if (test == "file") {
-        vector<string> l = loader("input.txt");
-        
-        mode = l[0];
-        source = stoi(l[1]);
-        destination = stoi(l[2]);
-        
-        if (l[5] == "") I = 0;
-        else I = stoi(l[5]);
-        N = l[3]; S = l[4];
-
-        NSI = {N != "", S != "", I != 0};
-        type = (NSI[0] || NSI[1] || NSI[2]) ? 1 : 0;
-
+        getline(cin >> ws, cmdLine);
     }
-    else { ///< In case of a misspelled input, the program exits.
+    else if (test != "file") { ///< In case of a misspelled input, the program exits.
         cout << "Exited successfully" << endl;
         exit(EXIT_SUCCESS);
     }
 }
 
 /**
- * @brief Computes and displays routing results.
- * @details Calls Dijkstra's algorithm for optimal and restricted routing.
- * @complexity O((V + E) log V) for Dijkstra's algorithm, where E is edges and V is vertices.
+ * @brief Writes the routes of a query.
+ * @details Unrestricted queries get the best and the alternative route; restricted ones
+ * get the restricted route. Queries whose time limit stopped the search are reported
+ * on cerr.
+ *
+ * @param q Query that was answered.
+ * @param a Its routes.
+ * @param out Writer that receives the result.
+ * @complexity O(P), for P vertices in the routes.
  */
-void results() {
-    Graph<int> drive, walk; ///< Graphs for driving and walking routes.
-    loadGraphs(drive, walk); ///< Loads Graphs with vertices(locations) and edges(distances).
+void writeAnswer(const RouteQuery& q, const QueryAnswer& a, ResultWriter& out) {
+    out.beginResult(q.source, q.destination);
+    if (!q.isRestricted()) { ///< Best and Alternative Routes
+        out.addRoute("BestDrivingRoute", a.primPath, a.primW);
+        out.addRoute("AlternativeDrivingRoute", a.secPath, a.secW);
+    }
+    else { ///< Restricted Route
+        out.addRoute("RestrictedDrivingRoute", a.primPath, a.primW);
+    }
+    out.endResult();
+    if (a.status != SEARCH_OK) {
+        cerr << "Warning: query at line " << q.line << ": " << q.timeLimitMs
+             << " ms time limit reached (" << statusName(a.status) << ")" << endl;
+    }
+}
 
-    if (type == 0) { ///< Best and Alternative Routes
-        int primW = 0, secW = 0;
-        vector<int> primPath, secPath;
+/**
+ * @brief Reports the allocations made since a point on cerr, if they are counted.
+ * @param what Name of the work done since then.
+ * @param before Counters at that point, from memoryMark.
+ * @param queries Number of queries answered since then.
+ */
+void reportAllocations(const char* what, const MemoryUsage& before, size_t queries) {
+    if (!memoryHooksEnabled()) return;
+    MemCounters d = memoryDelta(before, memoryUsage());
+    cerr << "Memory: " << what << " (" << queries << (queries == 1 ? " query" : " queries") << ") made "
+         << d.allocs << " allocations (" << d.allocated << " bytes); heap peak " << d.peak
+         << " bytes above the start" << endl;
+}
 
-        Routing(drive, source, destination, primPath, secPath, primW, secW);
+/**
+ * @brief Computes and displays routing results.
+ * @details Parses the query (or every query of 'input.txt'), validates it against the
+ * loaded graph and writes the results to the console ("cmd") or to 'output.txt' ("file")
+ * through a ResultWriter. Invalid queries are reported on cerr and skipped. In "file" mode
+ * all queries are read first and answered as one batch (see batchPlanner.h), on the
+ * snapshot they were validated against. Builds with allocation counters
+ * (make memstats) report the allocations of the query or batch on cerr.
+ * @complexity O(Q (V + E) log V), for Q queries.
+ */
+void results() {
+    NetworkStore store; ///< Loads the csv files once.
+    Graph<int> drive, walk;
+    shared_ptr<const NetworkSnapshot> net = store.snapshot(); ///< validation and answers use this one
+    net->fillGraphs(drive, walk);
+    vector<int> ids = sortedVertexIds(drive); ///< valid node IDs
+    LocationResolver resolver; ///< lets queries name locations by code or name
+    resolver.load(net->getLocationLines());
 
-        if (test == "cmd") {
-            cout << "Source:" << source << endl << "Destination:" << destination << endl;
-            if (!primPath.empty()) {
-                cout << "BestDrivingRoute:" << primPath[0];
-                for (int i = 1; i < primPath.size(); i++) {
-                    cout << "," << primPath[i];
-                }
-                cout << "(" << primW << ")" << endl;
-            } else {
-                cout << "BestDrivingRoute:none" << endl;
-            }
-            if (!secPath.empty()) {
-                cout << "AlternativeDrivingRoute:" << secPath[0];
-                for (int i = 1; i < secPath.size(); i++) {
-                    cout << "," << secPath[i];
-                }
-                cout << "(" << secW << ")" << endl;
-            } else {
-                cout << "AlternativeDrivingRoute:none" << endl;
-            }
-        }
-        else {
-            ofstream outFile("output.txt");
-            if (!outFile.is_open()) {
-                cerr << "Error: Could not open output file" << endl;
-                return;
-            }
-            outFile << "Source:" << source << endl << "Destination:" << destination << endl;
-            if (!primPath.empty()) {
-                outFile << "BestDrivingRoute:" << primPath[0];
-                for (int i = 1; i < primPath.size(); i++) {
-                    outFile << "," << primPath[i];
-                }
-                outFile << "(" << primW << ")" << endl;
-            } else {
-                outFile << "BestDrivingRoute:none" << endl;
-            }
-            if (!secPath.empty()) {
-                outFile << "AlternativeDrivingRoute:" << secPath[0];
-                for (int i = 1; i < secPath.size(); i++) {
-                    outFile << "," << secPath[i];
-                }
-                outFile << "(" << secW << ")" << endl;
-            } else {
-                outFile << "AlternativeDrivingRoute:none" << endl;
-            }
-            cout << "Result in 'output.txt' file" << endl;
-            outFile.close();
+    if (test == "cmd") {
+        RouteQuery q;
+        string err;
+        if (!parseCommandQuery(cmdLine, q, err, &resolver) || !validateQuery(q, ids, err)) {
+            cerr << "Error: " << err << endl;
+            return;
         }
+        cout.flush(); ///< the writer bypasses cout, so pending prompts go first
+        ResultWriter out(STDOUT_FILENO, FORMAT_TEXT);
+        MemoryUsage before = memoryMark();
+        writeAnswer(q, answerQuery(q, *net), out);
+        reportAllocations("query", before, 1);
+        return;
+    }
+
+    ifstream in("input.txt");
+    if (!in.is_open()) {
+        cerr << "Error: Could not open file input.txt" << endl;
+        return;
     }
-    if (type == 1) { ///< Restricted Route
-        int w = 0;
-        vector<int> path;
-        avoidRouting(drive, source, destination, NSI, N, S, I, path, w);
-        if (test == "cmd") {
-            cout << "Source:" << source << endl << "Destination:" << destination << endl;
-            if (!path.empty()) {
-                cout << "RestrictedDrivingRoute:" << path[0];
-                for (int i = 1; i < path.size(); i++) {
-                    cout << "," << path[i];
-                }
-                cout << "(" << w << ")" << endl;
-            } else {
-                cout << "RestrictedDrivingRoute:none" << endl;
+    int fd = open("output.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        cerr << "Error: Could not open output file" << endl;
+        return;
+    }
+    {
+        ResultWriter out(fd, FORMAT_TEXT);
+        QueryParser parser(in, &drive, &resolver);
+        vector<RouteQuery> batch;
+        RouteQuery q;
+        ParseStatus st;
+        while ((st = parser.next(q)) != PARSE_END) {
+            if (st == PARSE_ERROR) {
+                cerr << "Error: input.txt " << parser.error() << endl;
+                continue;
             }
+            batch.push_back(q);
         }
-        else {
-            ofstream outFile("output.txt");
-            if (!outFile.is_open()) {
-                cerr << "Error: Could not open output file" << endl;
-                return;
-            }
-            outFile << "Source:" << source << endl << "Destination:" << destination << endl;
-            if (!path.empty()) {
-                outFile << "RestrictedDrivingRoute:" << path[0];
-                for (int i = 1; i < path.size(); i++) {
-                    outFile << "," << path[i];
-                }
-                outFile << "(" << w << ")" << endl;
-            } else {
-                outFile << "RestrictedDrivingRoute:none" << endl;
-            }
-            cout << "Result in 'output.txt' file" << endl;
-            outFile.close();
+        MemoryUsage before = memoryMark();
+        vector<QueryAnswer> answers = answerBatch(batch, *net);
+        reportAllocations("batch", before, batch.size());
+        for (size_t i = 0; i < batch.size(); i++) {
+            writeAnswer(batch[i], answers[i], out);
         }
     }
+    close(fd);
+    cout << "Result in 'output.txt' file" << endl;
 }
 
 /**
@@ -176,5 +164,6 @@ void results() {
 int main() {
     menu();
     results();
+    if (memoryHooksEnabled()) printMemoryReport(cerr, memoryUsage());
     return 0;
 }
@@ -0,0 +1,67 @@
+/**
+ * @file embedded-route.cpp
+ * @brief best-route for a fixed network compiled into the binary.
+ * @details Reads queries in the format of input.txt (see queryParser.h) and writes
+ * the results to standard output in the text format of best-route. The network comes
+ * from embeddedNetwork.h, generated from data/ at build time (make embedded), so
+ * nothing is loaded or parsed at startup.
+ *
+ * Usage: embedded-route [query file]   (reads input.txt by default)
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#include <iostream>
+#include <fstream>
+#include <unistd.h>
+#include "embeddedNetwork.h"
+#include "helper/resultWriter.h"
+
+using namespace std;
+
+static EmbeddedSearch<EMBEDDED_VERTICES, EMBEDDED_DRIVE_EDGES> querySearch; ///< reused by every query
+
+/**
+ * @brief Checks that every location a query references is in the embedded network.
+ */
+static bool knownIds(const RouteQuery &q) {
+    if (embeddedNetwork.findSlot(q.source) < 0 || embeddedNetwork.findSlot(q.destination) < 0) return false;
+    if (q.includeNode != 0 && embeddedNetwork.findSlot(q.includeNode) < 0) return false;
+    for (int id : q.avoidNodes)
+        if (embeddedNetwork.findSlot(id) < 0) return false;
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    const char *file = argc > 1 ? argv[1] : "input.txt";
+    ifstream in(file);
+    if (!in.is_open()) {
+        cerr << "Error: Could not open file " << file << endl;
+        return EXIT_FAILURE;
+    }
+    ResultWriter out(STDOUT_FILENO, FORMAT_TEXT);
+    QueryParser parser(in, nullptr);
+    RouteQuery q;
+    ParseStatus st;
+    while ((st = parser.next(q)) != PARSE_END) {
+        if (st == PARSE_ERROR) {
+            cerr << "Error: " << file << " " << parser.error() << endl;
+            continue;
+        }
+        if (!knownIds(q)) {
+            cerr << "Error: " << file << " line " << q.line << ": unknown node ID" << endl;
+            continue;
+        }
+        QueryAnswer a = embeddedAnswer(embeddedNetwork, querySearch, q);
+        out.beginResult(q.source, q.destination);
+        if (!q.isRestricted()) {
+            out.addRoute("BestDrivingRoute", a.primPath, a.primW);
+            out.addRoute("AlternativeDrivingRoute", a.secPath, a.secW);
+        }
+        else {
+            out.addRoute("RestrictedDrivingRoute", a.primPath, a.primW);
+        }
+        out.endResult();
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+/**
+ * @file gen-network.cpp
+ * @brief Generates the embedded network header from the csv files.
+ * @details Loads Locations.csv and Distances.csv into a MultiLayerGraph (loadNetwork)
+ * and writes its vertex table and driving and walking layers as constexpr arrays, together with the location codes, a parking bitset,
+ * an ID lookup table and the embeddedNetwork constant that embeddedRouting.h routes
+ * on. The Makefile runs it whenever the csv files change.
+ *
+ * Usage: gen-network <data directory> <output header>
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <algorithm>
+#include "helper/csvLoader.h"
+
+using namespace std;
+
+/**
+ * @brief Writes a constexpr int array, 16 values per line.
+ */
+static void writeArray(ostream &out, const char *name, const vector<int> &values) {
+    out << "constexpr int " << name << "[" << max<size_t>(values.size(), 1) << "] = {";
+    for (size_t i = 0; i < values.size(); i++) {
+        out << (i % 16 == 0 ? "\n    " : " ") << values[i] << (i + 1 < values.size() ? "," : "");
+    }
+    if (values.empty()) out << "0";
+    out << "\n};\n\n";
+}
+
+/**
+ * @brief Writes a string literal, escaping what C++ needs escaped.
+ */
+static void writeString(ostream &out, const string &s) {
+    out << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') out << '\\' << c;
+        else if ((unsigned char) c < 0x20) out << "\\x" << hex << (int) (unsigned char) c << dec << "\"\"";
+        else out << c;
+    }
+    out << '"';
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        cerr << "Usage: " << argv[0] << " <data directory> <output header>" << endl;
+        return EXIT_FAILURE;
+    }
+    string dir = argv[1];
+    MultiLayerGraph<int> net;
+    unordered_map<string, string> locations; // code -> ID
+    loadNetwork(dir + "/Locations.csv", dir + "/Distances.csv", net, &locations);
+    if (net.getNumVertex() == 0) {
+        cerr << "Error: no locations in " << dir << endl;
+        return EXIT_FAILURE;
+    }
+
+    const GraphLayer<int> &d = net.getLayer(LAYER_DRIVE), &w = net.getLayer(LAYER_WALK);
+    int n = net.getNumVertex();
+    vector<int> ids(n), sortedSlots(n), sortedIds(n);
+    vector<string> codes(n);
+    vector<int> parking((n + 7) / 8, 0);
+    unordered_map<string, string> codeOf; // ID -> code
+    for (auto &l : locations) codeOf[l.second] = l.first;
+    for (int s = 0; s < n; s++) {
+        ids[s] = net.getInfo(s);
+        codes[s] = codeOf[to_string(ids[s])];
+        if (net.hasParking(s)) parking[s / 8] |= 1 << (s % 8);
+        sortedSlots[s] = s;
+    }
+    sort(sortedSlots.begin(), sortedSlots.end(), [&](int a, int b) { return ids[a] < ids[b]; });
+    for (int i = 0; i < n; i++) sortedIds[i] = ids[sortedSlots[i]];
+
+    ofstream out(argv[2]);
+    if (!out.is_open()) {
+        cerr << "Error: Could not open " << argv[2] << endl;
+        return EXIT_FAILURE;
+    }
+    out << "// Generated by gen-network from " << dir << "/Locations.csv and " << dir
+        << "/Distances.csv. Do not edit.\n\n"
+        << "#ifndef EMBEDDEDNETWORK_H\n#define EMBEDDEDNETWORK_H\n\n"
+        << "#include \"helper/embeddedRouting.h\"\n\n"
+        << "constexpr int EMBEDDED_VERTICES = " << n << ";\n"
+        << "constexpr int EMBEDDED_DRIVE_EDGES = " << d.getNumEdges() << ";\n"
+        << "constexpr int EMBEDDED_WALK_EDGES = " << w.getNumEdges() << ";\n\n";
+    writeArray(out, "embeddedIds", ids);
+    out << "constexpr const char *embeddedCodes[" << n << "] = {";
+    for (int s = 0; s < n; s++) {
+        out << (s % 8 == 0 ? "\n    " : " ");
+        writeString(out, codes[s]);
+        out << (s + 1 < n ? "," : "");
+    }
+    out << "\n};\n\n";
+    out << "constexpr unsigned char embeddedParking[" << parking.size() << "] = {";
+    for (size_t i = 0; i < parking.size(); i++) {
+        out << (i % 16 == 0 ? "\n    " : " ") << parking[i] << (i + 1 < parking.size() ? "," : "");
+    }
+    out << "\n};\n\n";
+    writeArray(out, "embeddedSortedIds", sortedIds);
+    writeArray(out, "embeddedSortedSlots", sortedSlots);
+    writeArray(out, "embeddedDriveOffsets", d.getOffsets());
+    writeArray(out, "embeddedDriveTargets", d.getTargets());
+    writeArray(out, "embeddedDriveWeights", d.getWeights());
+    writeArray(out, "embeddedWalkOffsets", w.getOffsets());
+    writeArray(out, "embeddedWalkTargets", w.getTargets());
+    writeArray(out, "embeddedWalkWeights", w.getWeights());
+    out << "typedef EmbeddedNetwork<EMBEDDED_VERTICES, EMBEDDED_DRIVE_EDGES, EMBEDDED_WALK_EDGES> EmbeddedNet;\n\n"
+        << "constexpr EmbeddedNet embeddedNetwork = {\n"
+        << "    embeddedIds, embeddedCodes, embeddedParking, embeddedSortedIds, embeddedSortedSlots,\n"
+        << "    {embeddedDriveOffsets, embeddedDriveTargets, embeddedDriveWeights},\n"
+        << "    {embeddedWalkOffsets, embeddedWalkTargets, embeddedWalkWeights}\n"
+        << "};\n\n"
+        << "#endif //EMBEDDEDNETWORK_H\n";
+    out.close();
+    if (!out) {
+        cerr << "Error: Could not write " << argv[2] << endl;
+        return EXIT_FAILURE;
+    }
+    cout << "Embedded " << n << " locations, " << d.getNumEdges() << " driving and "
+         << w.getNumEdges() << " walking segments into " << argv[2] << endl;
+    return 0;
+}
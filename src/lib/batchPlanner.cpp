@@ -0,0 +1,155 @@
+/**
+ * @file batchPlanner.cpp
+ * @brief Definitions of the batch planner declared in batchPlanner.h.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#include <map>
+#include "helper/batchPlanner.h"
+#include "helper/routing.h"
+
+using namespace std;
+
+void dijkstraWithout(Graph<int> *g, int origin, const vector<int> &blocked) {
+    MemoryScope scope(MEM_SEARCH);
+    for (auto v : g->getVertexSet()) {
+        v->setDist(INF);
+        v->setPath(nullptr);
+        v->setVisited(false);
+    }
+    for (int id : blocked) {
+        Vertex<int> *v = g->findVertex(id);
+        if (v != nullptr) v->setVisited(true);
+    }
+    Vertex<int> *start = g->findVertex(origin);
+    if (start == nullptr || start->isVisited()) return;
+    start->setDist(0);
+    MutablePriorityQueue<Vertex<int>> q;
+    q.insert(start);
+    while (!q.empty()) {
+        auto u = q.extractMin();
+        u->setVisited(true);
+        for (auto e : u->getAdj()) {
+            if (e->getDest()->isVisited()) continue; // settled or blocked
+            double oldDist = e->getDest()->getDist();
+            if (relax(e)) {
+                if (oldDist == INF) {
+                    q.insert(e->getDest());
+                } else {
+                    q.decreaseKey(e->getDest());
+                }
+            }
+        }
+    }
+}
+
+QueryAnswer answerQuery(const RouteQuery &q, const NetworkSnapshot &net) {
+    QueryAnswer a;
+    Graph<int> drive, walk;
+    net.fillGraphs(drive, walk);
+    SearchControl control;
+    if (q.timeLimitMs > 0) control.setTimeout(q.timeLimitMs);
+
+    if (!q.isRestricted()) {
+        a.status = Routing(drive, q.source, q.destination, a.primPath, a.secPath, a.primW, a.secW, &control);
+    }
+    else {
+        a.status = avoidRouting(drive, q.source, q.destination, q.avoidNodes, q.avoidSegments, q.includeNode,
+                                a.primPath, a.primW, &control);
+    }
+    return a;
+}
+
+namespace {
+
+/*
+ * A route to read from the tree of a shared source.
+ */
+enum LegKind {
+    LEG_BEST,         // best route of an unrestricted query
+    LEG_TO_INCLUDE,   // source -> include node
+    LEG_FROM_INCLUDE  // include node -> destination
+};
+
+struct Leg {
+    int query;
+    LegKind kind;
+};
+
+}
+
+vector<QueryAnswer> answerBatch(const vector<RouteQuery> &queries, const NetworkSnapshot &net, BatchStats *stats) {
+    MemoryScope scope(MEM_SEARCH);
+    vector<QueryAnswer> answers(queries.size());
+    BatchStats st;
+    st.queries = queries.size();
+
+    Graph<int> drive, walk;
+    net.fillGraphs(drive, walk);
+
+    // plan: which legs each tree source serves
+    map<int, vector<Leg>> groups;
+    for (size_t i = 0; i < queries.size(); i++) {
+        const RouteQuery &q = queries[i];
+        if (q.timeLimitMs > 0 || !q.avoidNodes.empty() || !q.avoidSegments.empty()) {
+            answers[i] = answerQuery(q, net);
+            st.ownSearches++;
+            continue;
+        }
+        st.shared++;
+        if (q.includeNode == 0) {
+            if (mayReach(&drive, q.source, q.destination)) groups[q.source].push_back({(int) i, LEG_BEST});
+        }
+        else if (mayReach(&drive, q.source, q.includeNode) && mayReach(&drive, q.includeNode, q.destination)) {
+            groups[q.source].push_back({(int) i, LEG_TO_INCLUDE});
+            groups[q.includeNode].push_back({(int) i, LEG_FROM_INCLUDE});
+        }
+    }
+
+    // one tree per source; legs from the include node are kept until both are known
+    vector<vector<int>> toInclude(queries.size()), fromInclude(queries.size());
+    vector<int> toW(queries.size(), 0), fromW(queries.size(), 0);
+    for (auto &group : groups) {
+        int source = group.first;
+        dijkstra(&drive, source);
+        st.trees++;
+        vector<int> needAlternative;
+        for (const Leg &leg : group.second) {
+            const RouteQuery &q = queries[leg.query];
+            QueryAnswer &a = answers[leg.query];
+            switch (leg.kind) {
+                case LEG_BEST:
+                    a.primPath = getPath(&drive, q.destination, a.primW);
+                    if (!a.primPath.empty()) needAlternative.push_back(leg.query);
+                    break;
+                case LEG_TO_INCLUDE:
+                    toInclude[leg.query] = getPath(&drive, q.includeNode, toW[leg.query]);
+                    break;
+                case LEG_FROM_INCLUDE:
+                    fromInclude[leg.query] = getPath(&drive, q.destination, fromW[leg.query]);
+                    break;
+            }
+        }
+        // the alternative routes overwrite the tree, so they come last
+        for (int i : needAlternative) {
+            QueryAnswer &a = answers[i];
+            vector<int> interior;
+            if (a.primPath.size() > 2) interior.assign(a.primPath.begin() + 1, a.primPath.end() - 1);
+            dijkstraWithout(&drive, source, interior);
+            a.secPath = getPath(&drive, queries[i].destination, a.secW);
+        }
+    }
+
+    // join the two legs of include-node queries, as avoidRouting does
+    for (size_t i = 0; i < queries.size(); i++) {
+        if (toInclude[i].empty() || fromInclude[i].empty()) continue;
+        QueryAnswer &a = answers[i];
+        a.primPath = toInclude[i];
+        a.primPath.insert(a.primPath.end(), fromInclude[i].begin() + 1, fromInclude[i].end());
+        a.primW = toW[i] + fromW[i];
+    }
+
+    if (stats != nullptr) *stats = st;
+    return answers;
+}
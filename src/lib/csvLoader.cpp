@@ -0,0 +1,180 @@
+/**
+ * @file csvLoader.cpp
+ * @brief Definitions of the csv loaders declared in csvLoader.h.
+ * @details Every row of both files is parsed by parseLocationRow or parseDistanceRow,
+ * shared by the Graph loaders, loadNetwork and the incremental reload of hotReload.h,
+ * so that every loader accepts and rejects the same rows. Invalid rows are reported on
+ * cerr and skipped.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include "helper/csvLoader.h"
+#include "helper/removers.h"
+#include "helper/scc.h"
+
+using namespace std;
+
+/**
+ * @brief Parses a whole csv field as an integer (a trailing '\r' is ignored).
+ */
+static bool parseField(const string &field, int &value) {
+    const char *p = field.data(), *end = p + field.size();
+    if (p < end && end[-1] == '\r') end--;
+    return parseInt(p, end, value) && p == end;
+}
+
+bool parseLocationRow(const string& line, string& code, int& id, bool& parking) {
+    stringstream ss(line);
+    string loc, loc_id, park;
+    getline(ss, loc, ',');
+    getline(ss, loc_id, ',');
+    getline(ss, code, ',');
+    getline(ss, park, ',');
+
+    int flag;
+    if (!parseField(loc_id, id) || !parseField(park, flag)) return false;
+    parking = flag != 0;
+    return true;
+}
+
+bool parseDistanceRow(const string& line, string& src, string& dest, int& driving, int& walking) {
+    stringstream ss(line);
+    string drive, walk;
+    getline(ss, src, ',');  // Read **source location name**
+    getline(ss, dest, ','); // Read **destination location name**
+    getline(ss, drive, ',');
+    getline(ss, walk, ',');
+    if (!walk.empty() && walk.back() == '\r') walk.pop_back();
+
+    //Handle the driving and walking routes that are cut ('X' in the csv)
+    auto time = [](const string &field, int &value) {
+        if (field == "X") value = -1;
+        return field == "X" || (parseField(field, value) && value >= 0);
+    };
+    return time(drive, driving) && time(walk, walking);
+}
+
+/**
+ * @brief Reads Locations.csv, calling f(code, id, parking) for every valid row.
+ * @return False if the file could not be opened.
+ */
+template <class F>
+static bool readLocations(const string &filePath, F f) {
+    ifstream file(filePath);
+    string line, code;
+
+    if (!file.is_open()) {
+        cerr << "Error opening file: " << filePath << endl;
+        return false;
+    }
+
+    getline(file, line); // skip header
+    while (getline(file, line)) {
+        int id;
+        bool parking;
+        if (!parseLocationRow(line, code, id, parking)) {
+            cerr << "Warning: skipping invalid location " << code << " in " << filePath << endl;
+            continue;
+        }
+        f(code, id, parking);
+    }
+    return true;
+}
+
+/**
+ * @brief Reads Distances.csv, calling f(source ID, destination ID, driving, walking)
+ * for every valid row; a cut segment ('X' in the csv) is passed as -1.
+ * @param locations Map of location codes to their IDs.
+ * @return False if the file could not be opened.
+ */
+template <class F>
+static bool readDistances(const string &filePath, const unordered_map<string, string> &locations, F f) {
+    ifstream file(filePath);
+    string line, src, dest;
+
+    if (!file.is_open()) {
+        cerr << "Error opening file: " << filePath << endl;
+        return false;
+    }
+
+    getline(file, line); // Skip header
+    while (getline(file, line)) {
+        int src_id, dest_id, drive, walk;
+        bool valid = parseDistanceRow(line, src, dest, drive, walk);
+        auto s = locations.find(src), d = locations.find(dest);
+        if (!valid || s == locations.end() || d == locations.end() || !parseField(s->second, src_id) ||
+            !parseField(d->second, dest_id)) {
+            cerr << "Warning: skipping invalid segment " << src << "," << dest << " in " << filePath << endl;
+            continue;
+        }
+        f(src_id, dest_id, drive, walk);
+    }
+    return true;
+}
+
+void loadDistances(const string& filePath, unordered_map<string, string>& locations, Graph<int>& drive, Graph<int>& walk) {
+    MemoryScope scope(MEM_LOADER);
+    readDistances(filePath, locations, [&](int src, int dest, int driving, int walking) {
+        if (driving >= 0) drive.addEdge(src, dest, driving);
+        if (walking >= 0) walk.addEdge(src, dest, walking);
+    });
+}
+
+void loadLocations(const string& filePath, Graph<int>& g1, Graph<int>& g2, unordered_map<string, string>& locations) {
+    MemoryScope scope(MEM_LOADER);
+    readLocations(filePath, [&](const string &code, int id, bool parking) {
+        locations[code] = to_string(id);
+        g1.addVertex(id);
+        g2.addVertex(id);
+        g1.findVertex(id)->setParking(parking);
+        g2.findVertex(id)->setParking(parking);
+    });
+}
+
+void loadGraphs(Graph<int>& drive, Graph<int>& walk, unordered_map<string, string>* codes) {
+    MemoryScope scope(MEM_LOADER);
+    string distancesFile = "data/Distances.csv";
+    string locationsFile = "data/Locations.csv";
+
+    unordered_map<string, string> locations;
+
+    // Load locations first (ensures vertices exist)
+    loadLocations(locationsFile, drive, walk, locations);
+
+    // Load distances (now vertices exist, so edges can be added safely)
+    loadDistances(distancesFile, locations, drive, walk);
+
+    // Reachability labels, so that impossible queries are answered without a search
+    computeComponents(&drive);
+    computeComponents(&walk);
+
+    if (codes != nullptr) {
+        codes->swap(locations);
+    }
+}
+
+void loadNetwork(const string& locationsFile, const string& distancesFile, MultiLayerGraph<int>& g,
+                 unordered_map<string, string>* codes) {
+    MemoryScope scope(MEM_LOADER);
+    unordered_map<string, string> locations;
+    g.addLayer("drive"); // LAYER_DRIVE
+    g.addLayer("walk");  // LAYER_WALK
+
+    readLocations(locationsFile, [&](const string &code, int id, bool parking) {
+        locations[code] = to_string(id);
+        g.addVertex(id, parking);
+    });
+    readDistances(distancesFile, locations, [&](int src, int dest, int driving, int walking) {
+        if (driving >= 0) g.addEdge(LAYER_DRIVE, src, dest, driving);
+        if (walking >= 0) g.addEdge(LAYER_WALK, src, dest, walking);
+    });
+    g.build();
+
+    if (codes != nullptr) {
+        codes->swap(locations);
+    }
+}
@@ -0,0 +1,206 @@
+/**
+ * @file memoryStats.cpp
+ * @brief Counters and allocation hooks declared in memoryStats.h.
+ * @details With BESTROUTE_MEMORY_HOOKS, this file replaces the global operator new
+ * and delete. Each block is allocated with malloc and a 16-byte header in front of it
+ * that holds the requested size and the subsystem that allocated it.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <iomanip>
+#include <sys/resource.h>
+#include "helper/memoryStats.h"
+
+using namespace std;
+
+long long peakResidentBytes() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return (long long) usage.ru_maxrss * 1024; // kilobytes on Linux
+}
+
+void printMemoryReport(ostream &out, const MemoryUsage &usage) {
+    if (memoryHooksEnabled()) {
+        out << left << setw(8) << "memory" << right << setw(12) << "allocs" << setw(12) << "frees"
+            << setw(16) << "bytes" << setw(14) << "live" << setw(14) << "peak" << endl;
+        for (int s = 0; s <= MEM_SUBSYSTEMS; s++) {
+            const MemCounters &c = s < MEM_SUBSYSTEMS ? usage.subsystem[s] : usage.total;
+            out << left << setw(8) << (s < MEM_SUBSYSTEMS ? subsystemName(s) : "total") << right
+                << setw(12) << c.allocs << setw(12) << c.frees << setw(16) << c.allocated
+                << setw(14) << c.current << setw(14) << c.peak << endl;
+        }
+    }
+    else {
+        out << "memory: allocation counters not built in (make memstats)" << endl;
+    }
+    out << "peak RSS: " << peakResidentBytes() << " bytes" << endl;
+}
+
+#ifdef BESTROUTE_MEMORY_HOOKS
+
+namespace {
+
+struct AtomicCounters {
+    atomic<long long> allocs, frees, allocated, current, peak;
+};
+
+AtomicCounters counters[MEM_SUBSYSTEMS + 1]; // the last one is the total; zero-initialized statically
+atomic<long long> markPeak;                   // highest total since the last memoryMark
+
+thread_local MemSubsystem tag = MEM_OTHER;
+
+const size_t HEADER = 16; // keeps the alignment of malloc for the block itself
+
+struct BlockHeader {
+    size_t size;
+    int subsystem;
+};
+
+void raisePeak(atomic<long long> &peak, long long value) {
+    long long p = peak.load(memory_order_relaxed);
+    while (value > p && !peak.compare_exchange_weak(p, value, memory_order_relaxed)) {}
+}
+
+long long count(AtomicCounters &c, long long size) {
+    c.allocs.fetch_add(1, memory_order_relaxed);
+    c.allocated.fetch_add(size, memory_order_relaxed);
+    long long current = c.current.fetch_add(size, memory_order_relaxed) + size;
+    raisePeak(c.peak, current);
+    return current;
+}
+
+void uncount(AtomicCounters &c, long long size) {
+    c.frees.fetch_add(1, memory_order_relaxed);
+    c.current.fetch_sub(size, memory_order_relaxed);
+}
+
+void *countedAlloc(size_t size) {
+    void *raw = malloc(HEADER + size);
+    if (raw == nullptr) return nullptr;
+    BlockHeader *h = static_cast<BlockHeader *>(raw);
+    h->size = size;
+    h->subsystem = tag;
+    count(counters[tag], size);
+    raisePeak(markPeak, count(counters[MEM_SUBSYSTEMS], size));
+    return static_cast<char *>(raw) + HEADER;
+}
+
+void countedFree(void *p) {
+    if (p == nullptr) return;
+    void *raw = static_cast<char *>(p) - HEADER;
+    BlockHeader *h = static_cast<BlockHeader *>(raw);
+    uncount(counters[h->subsystem], h->size);
+    uncount(counters[MEM_SUBSYSTEMS], h->size);
+    free(raw);
+}
+
+void *throwingAlloc(size_t size) {
+    for (;;) {
+        void *p = countedAlloc(size);
+        if (p != nullptr) return p;
+        new_handler handler = get_new_handler();
+        if (handler == nullptr) throw bad_alloc();
+        handler();
+    }
+}
+
+MemCounters load(const AtomicCounters &c) {
+    MemCounters m;
+    m.allocs = c.allocs.load(memory_order_relaxed);
+    m.frees = c.frees.load(memory_order_relaxed);
+    m.allocated = c.allocated.load(memory_order_relaxed);
+    m.current = c.current.load(memory_order_relaxed);
+    m.peak = c.peak.load(memory_order_relaxed);
+    return m;
+}
+
+}
+
+MemSubsystem &currentSubsystem() {
+    return tag;
+}
+
+bool memoryHooksEnabled() {
+    return true;
+}
+
+MemoryUsage memoryUsage() {
+    MemoryUsage u;
+    for (int s = 0; s < MEM_SUBSYSTEMS; s++) u.subsystem[s] = load(counters[s]);
+    u.total = load(counters[MEM_SUBSYSTEMS]);
+    u.markPeak = markPeak.load(memory_order_relaxed);
+    return u;
+}
+
+MemoryUsage memoryMark() {
+    markPeak.store(counters[MEM_SUBSYSTEMS].current.load(memory_order_relaxed), memory_order_relaxed);
+    return memoryUsage();
+}
+
+void *operator new(size_t size) {
+    return throwingAlloc(size);
+}
+
+void *operator new[](size_t size) {
+    return throwingAlloc(size);
+}
+
+void *operator new(size_t size, const nothrow_t &) noexcept {
+    try {
+        return throwingAlloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void *operator new[](size_t size, const nothrow_t &) noexcept {
+    try {
+        return throwingAlloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void *p) noexcept {
+    countedFree(p);
+}
+
+void operator delete[](void *p) noexcept {
+    countedFree(p);
+}
+
+void operator delete(void *p, const nothrow_t &) noexcept {
+    countedFree(p);
+}
+
+void operator delete[](void *p, const nothrow_t &) noexcept {
+    countedFree(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    countedFree(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+    countedFree(p);
+}
+
+#else
+
+bool memoryHooksEnabled() {
+    return false;
+}
+
+MemoryUsage memoryUsage() {
+    return MemoryUsage();
+}
+
+MemoryUsage memoryMark() {
+    return MemoryUsage();
+}
+
+#endif
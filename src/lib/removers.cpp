@@ -0,0 +1,62 @@
+/**
+ * @file removers.cpp
+ * @brief Definitions of the graph removal functions declared in removers.h.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#include "helper/removers.h"
+
+using namespace std;
+
+vector<int> parseAvoidNodes(const string& nodes) {
+    vector<int> avoidNodes;
+    if (!parseAvoidNodes(nodes.data(), nodes.data() + nodes.size(), avoidNodes)) avoidNodes.clear();
+    return avoidNodes;
+}
+
+vector<pair<int, int>> parseAvoidSegments(const string& Segments) {
+    vector<pair<int, int>> avoidSegments;
+    if (!parseAvoidSegments(Segments.data(), Segments.data() + Segments.size(), avoidSegments)) avoidSegments.clear();
+    return avoidSegments;
+}
+
+void removePath(Graph<int>* g, const std::vector<int>& path) {
+    for (size_t i = 1; i + 1 < path.size(); i++) {
+        int from = path[i];
+        int to = path[i + 1];
+
+        Vertex<int>* v = g->findVertex(from);
+        if (v != nullptr) {
+            for (auto& adj : v->getAdj()) {
+                if (adj->getDest()->getInfo() == to) {
+                    v->removeEdge(to);
+                    break;
+                }
+            }
+        }
+    }
+    for (size_t i = 1; i + 1 < path.size(); i++) {
+        g->removeVertex(path[i]);
+    }
+} //alterRouting
+
+void remNodes(Graph<int>* g, const vector<int>& avoidNodes) {
+    for (int id : avoidNodes) {
+        g->removeVertex(id);
+    }
+} //avoidNode
+
+void remNode(Graph<int>* g, string nodes) {
+    remNodes(g, parseAvoidNodes(nodes));
+}
+
+void remEdges(Graph<int>* g, const vector<pair<int, int>>& avoidSegments) {
+    for (auto& seg : avoidSegments) {
+        g->removeEdge(seg.first, seg.second);
+    }
+} //avoidSegment
+
+void remEdge(Graph<int>* g, string Segments) {
+    remEdges(g, parseAvoidSegments(Segments));
+}
@@ -0,0 +1,97 @@
+/**
+ * @file routing.cpp
+ * @brief Definitions of the routing functions declared in routing.h.
+ *
+ * @authors João Júnior, Mário Pereira, Vasco Sá
+ */
+
+#include "helper/routing.h"
+
+using namespace std;
+
+/*
+ * Route to the destination after a dijkstra from source that control may have stopped.
+ * A settled destination is exact; a tentative label or the fallback engine give a
+ * best-effort route (SEARCH_PARTIAL); otherwise the stop reason is returned.
+ */
+static SearchStatus searchedPath(Graph<int> & g1, int source, int destination, bool finished,
+                                 SearchControl * control, vector<int> & path, int & w) {
+    path = getPath(&g1, destination, w);
+    if (finished) return SEARCH_OK;
+    Vertex<int> *v = g1.findVertex(destination);
+    if (v != nullptr && v->isVisited()) return SEARCH_OK;
+    if (path.empty() && control->getFallback() && !control->getFallback()(g1, source, destination, path, w)) {
+        path.clear();
+    }
+    return path.empty() ? control->stopReason() : SEARCH_PARTIAL;
+}
+
+SearchStatus Routing(Graph<int> & g1, int source, int destination, std::vector<int> & primPath,
+                     std::vector<int> & secPath, int & primaryW, int & alterW, SearchControl * control){
+    MemoryScope scope(MEM_SEARCH);
+    if (!mayReach(&g1, source, destination)) {
+        return SEARCH_OK;
+    }
+
+    bool finished = dijkstra(&g1, source, control);
+    SearchStatus status = searchedPath(g1, source, destination, finished, control, primPath, primaryW);
+
+    if (primPath.empty() || status != SEARCH_OK){
+        return status;
+    }
+
+    removePath(&g1, primPath);
+    finished = dijkstra(&g1, source, control);
+    if (searchedPath(g1, source, destination, finished, control, secPath, alterW) != SEARCH_OK) {
+        return SEARCH_PARTIAL; // the best route is still exact
+    }
+
+    if (alterW < primaryW && alterW != 0) {
+        cerr << "bad dijkstra handling-- alterWeight < primaryWeight" << endl;
+        exit(EXIT_FAILURE);
+    }
+    return SEARCH_OK;
+}
+
+SearchStatus avoidRouting(Graph<int>& g1, int source, int destination, const vector<int>& avoidNodes,
+                          const vector<pair<int, int>>& avoidSegments, int I, std::vector<int> & path, int & weight,
+                          SearchControl * control) {
+    MemoryScope scope(MEM_SEARCH);
+    remNodes(&g1, avoidNodes);
+    remEdges(&g1, avoidSegments);
+
+    if (!mayReach(&g1, source, I == 0 ? destination : I) || (I != 0 && !mayReach(&g1, I, destination))) {
+        return SEARCH_OK;
+    }
+
+    if (I == 0) {
+        bool finished = dijkstra(&g1, source, control);
+        return searchedPath(g1, source, destination, finished, control, path, weight);
+    }
+
+    //shortest path to 'IncludeNode'
+    bool finished = dijkstra(&g1, source, control);
+    int w1 = 0;
+    vector<int> primPath;
+    SearchStatus s1 = searchedPath(g1, source, I, finished, control, primPath, w1);
+    if (primPath.empty()) {
+        return s1;
+    }
+    //shortest path from 'IncludeNode' to destination
+    finished = dijkstra(&g1, I, control);
+    int w2 = 0;
+    vector<int> secPath;
+    SearchStatus s2 = searchedPath(g1, I, destination, finished, control, secPath, w2);
+    if (secPath.empty()) {
+        return s2;
+    }
+    //
+    //appends------
+    //
+    path = primPath;
+    for (size_t i = 1; i < secPath.size(); i++) {
+        path.push_back(secPath[i]);
+    }
+    weight = w1 + w2;
+    return s1 == SEARCH_OK && s2 == SEARCH_OK ? SEARCH_OK : SEARCH_PARTIAL;
+}